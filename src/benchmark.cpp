@@ -0,0 +1,375 @@
+#include "benchmark.h"
+#include "components.h"
+#include "emitter.h"
+#include "random.h"
+#include "spatial_grid.h"
+#include "systems.h"
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const int FIELD_WIDTH = 1920;
+    const int FIELD_HEIGHT = 1080;
+    const int CELL_SIZE = 64;
+    const int TICKS = 120;
+    const int LINEAR_TICKS = 4; // The brute force reference gets slow quickly, so it runs fewer ticks
+
+    double Seconds(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Brute force nearest enemy, the reference the grid is compared against
+    Entity LinearNearest(const EnemyArchetype &enemies, Scalar x, Scalar y)
+    {
+        const auto &positions = enemies.Column<Position>();
+        Entity nearest = NO_ENTITY;
+        auto bestDistance = LengthSquared(Scalar(0), Scalar(0));
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            auto distance = LengthSquared(positions[i].x - x, positions[i].y - y);
+            if (nearest == NO_ENTITY || distance < bestDistance)
+            {
+                nearest = enemies.GetEntity(i);
+                bestDistance = distance;
+            }
+        }
+        return nearest;
+    }
+}
+
+int RunSpatialBenchmark()
+{
+    const int counts[] = {100, 250, 500, 1000, 2000, 4000, 8000};
+
+    std::printf("Nearest-enemy queries, one per missile per tick, enemies jittering every tick\n");
+    std::printf("%8s %8s %14s %14s %14s %10s\n", "enemies", "missiles", "sync us/tick", "grid ns/query", "linear ns/query", "mismatches");
+
+    unsigned long checksum = 0;
+    for (int count : counts)
+    {
+        Random random(12345);
+        EnemyArchetype enemies;
+        for (int i = 0; i < count; ++i)
+        {
+            SpawnEnemy(enemies, Scalar(random.Range(0, FIELD_WIDTH)), Scalar(random.Range(0, FIELD_HEIGHT)), 1, RED, Tuning());
+        }
+
+        std::vector<Position> missiles(count);
+        for (auto &missile : missiles)
+        {
+            missile = {Scalar(random.Range(0, FIELD_WIDTH)), Scalar(random.Range(0, FIELD_HEIGHT))};
+        }
+
+        SpatialGrid grid(0, 0, FIELD_WIDTH, FIELD_HEIGHT, CELL_SIZE);
+        double syncTime = 0;
+        double queryTime = 0;
+        double linearTime = 0;
+        int mismatches = 0;
+        auto &positions = enemies.Column<Position>();
+
+        for (int tick = 0; tick < TICKS; ++tick)
+        {
+            // Move everything a little, as a tick of gameplay would
+            for (auto &position : positions)
+            {
+                position.x = Clamp(position.x + random.Range(-4, 4), Scalar(0), Scalar(FIELD_WIDTH));
+                position.y = Clamp(position.y + random.Range(-4, 4), Scalar(0), Scalar(FIELD_HEIGHT));
+            }
+
+            Clock::time_point start = Clock::now();
+            grid.Sync(enemies);
+            syncTime += Seconds(start);
+
+            start = Clock::now();
+            Entity nearest;
+            Position nearestPosition;
+            for (const auto &missile : missiles)
+            {
+                if (grid.FindNearest(missile.x, missile.y, nearest, nearestPosition))
+                    checksum += nearest.index;
+            }
+            queryTime += Seconds(start);
+
+            if (tick >= LINEAR_TICKS)
+                continue;
+
+            start = Clock::now();
+            for (const auto &missile : missiles)
+            {
+                checksum += LinearNearest(enemies, missile.x, missile.y).index;
+            }
+            linearTime += Seconds(start);
+
+            // Ties can pick different entities, so compare distances rather than handles
+            for (const auto &missile : missiles)
+            {
+                grid.FindNearest(missile.x, missile.y, nearest, nearestPosition);
+                const Position &expected = enemies.Get<Position>(LinearNearest(enemies, missile.x, missile.y));
+                if (LengthSquared(nearestPosition.x - missile.x, nearestPosition.y - missile.y) !=
+                    LengthSquared(expected.x - missile.x, expected.y - missile.y))
+                    mismatches++;
+            }
+        }
+
+        double queries = static_cast<double>(count) * TICKS;
+        double linearQueries = static_cast<double>(count) * LINEAR_TICKS;
+        std::printf("%8d %8d %14.1f %14.1f %14.1f %10d\n", count, count, syncTime / TICKS * 1e6,
+                    queryTime / queries * 1e9, linearTime / linearQueries * 1e9, mismatches);
+    }
+
+    std::printf("(checksum %lu)\n", checksum);
+    return 0;
+}
+
+int RunBulletBenchmark()
+{
+    const int bossCounts[] = {1, 2, 4, 8, 16};
+    const int bulletTicks = 600;
+    const Scalar deltaTime = Scalar(1) / Scalar(60);
+
+    std::printf("Boss bullet patterns, %d ticks at 60 Hz, every boss mounting one emitter of each pattern\n", bulletTicks);
+    std::printf("%8s %14s %14s %14s %14s\n", "bosses", "avg bullets", "peak bullets", "us/tick", "ns/bullet");
+
+    for (int bosses : bossCounts)
+    {
+        EnemyArchetype enemies;
+        EmitterArchetype emitters;
+        PlayerArchetype players;
+        ShotArchetype bullets;
+        SpawnPlayer(players, Scalar(FIELD_WIDTH) / 2, Scalar(FIELD_HEIGHT) * 0.9f, 100, 100, Tuning());
+        for (int i = 0; i < bosses; ++i)
+        {
+            Scalar x = Scalar(FIELD_WIDTH) * (i + 1) / (bosses + 1);
+            Entity boss = enemies.Create({x, 200}, {160, 60}, {1, 1}, {MAROON}, {0, 0}, {BOSS, 0, 0, false, false});
+            for (int pattern = 0; pattern < PATTERN_COUNT; ++pattern)
+            {
+                SpawnEmitter(emitters, boss, 0, 0, pattern, 0);
+            }
+        }
+
+        double total = 0;
+        double bulletTicksTotal = 0;
+        size_t peak = 0;
+        for (int tick = 0; tick < bulletTicks; ++tick)
+        {
+            Clock::time_point start = Clock::now();
+            EmitterSystem(emitters, enemies, players, bullets, deltaTime);
+            MovementSystem(bullets, deltaTime);
+            OffScreenSystem(bullets, FIELD_WIDTH, FIELD_HEIGHT);
+            total += Seconds(start);
+            bulletTicksTotal += bullets.Size();
+            peak = Max(peak, bullets.Size());
+        }
+
+        std::printf("%8d %14.0f %14zu %14.1f %14.2f\n", bosses, bulletTicksTotal / bulletTicks, peak,
+                    total / bulletTicks * 1e6, total / Max(bulletTicksTotal, 1.0) * 1e9);
+    }
+    return 0;
+}
+
+namespace
+{
+    const int SWEEP_PHASES = 8;            // Starting distances spread over one tick's travel
+    const Scalar TARGET_X = 960;
+    const Scalar TARGET_Y = 540;
+    const Scalar SHOT_HALF_WIDTH = 4;      // Every projectile is 8x10
+    const Scalar TARGET_HALF_WIDTH = 10;   // Enemies are 20x20; the player is given a 20x20 body too
+
+    // How a projectile approaches the target
+    struct SweepCase
+    {
+        const char *name;
+        Velocity velocity;
+        Scalar offsetX; // Sideways from dead centre
+        bool hits;      // Whether the boxes overlap at some point along the path
+    };
+
+    struct SweepOutcome
+    {
+        bool swept;    // What the collision system reported
+        bool discrete; // Whether an overlap test at the end of each tick would have seen it too
+    };
+
+    // Where a projectile has to start to reach the target's centre line after travel seconds
+    Position StartFor(const SweepCase &sweep, Scalar travel)
+    {
+        return {TARGET_X + sweep.offsetX - sweep.velocity.x * travel, TARGET_Y - sweep.velocity.y * travel};
+    }
+
+    // The check swept collision replaced: the boxes overlapping where the projectile stands at the end of a tick
+    bool OverlapsAtEndOfTick(Position position, const Velocity &velocity, const Box &target, Scalar deltaTime, int ticks)
+    {
+        const Body body = {8, 10};
+        for (int tick = 0; tick < ticks; ++tick)
+        {
+            position.x += velocity.x * deltaTime;
+            position.y += velocity.y * deltaTime;
+            if (Overlaps(GetBounds(position, body), target))
+                return true;
+        }
+        return false;
+    }
+
+    // A player shot against one enemy, ticked the way HandleGameplay does until it is well past
+    SweepOutcome ShootEnemy(const SweepCase &sweep, Scalar travel, Scalar deltaTime, int ticks)
+    {
+        EnemyArchetype enemies;
+        BossArchetype bosses;
+        EmitterArchetype emitters;
+        ShotArchetype shots;
+        TrackedVector<Position, MEMORY_ENTITIES> kills;
+        GameEventBuffer events;
+        SpatialGrid grid(0, 0, FIELD_WIDTH, FIELD_HEIGHT, CELL_SIZE);
+        SpawnEnemy(enemies, TARGET_X, TARGET_Y, 1, RED, Tuning());
+        Box target = GetBounds(enemies.Column<Position>()[0], enemies.Column<Body>()[0]);
+        shots.Create(StartFor(sweep, travel), sweep.velocity, {8, 10}, {BLUE});
+
+        SweepOutcome outcome = {false, OverlapsAtEndOfTick(StartFor(sweep, travel), sweep.velocity, target, deltaTime, ticks)};
+        for (int tick = 0; tick < ticks && shots.Size() > 0 && enemies.Size() > 0; ++tick)
+        {
+            MovementSystem(shots, deltaTime);
+            grid.Sync(enemies);
+            ShotCollisionSystem(shots, enemies, bosses, emitters, grid, deltaTime, kills, events);
+        }
+        outcome.swept = enemies.Size() == 0;
+        return outcome;
+    }
+
+    // An enemy shot against the player
+    SweepOutcome ShootPlayer(const SweepCase &sweep, Scalar travel, Scalar deltaTime, int ticks)
+    {
+        PlayerArchetype players;
+        EnemyArchetype enemies;
+        BossArchetype bosses;
+        ShotArchetype shots;
+        BombArchetype bombs;
+        SpawnPlayer(players, TARGET_X, TARGET_Y, 40, 40, Tuning()); // Collision box is half the sprite
+        Box target = GetBounds(players.Column<Position>()[0], players.Column<Body>()[0]);
+        shots.Create(StartFor(sweep, travel), sweep.velocity, {8, 10}, {RED});
+
+        SweepOutcome outcome = {false, OverlapsAtEndOfTick(StartFor(sweep, travel), sweep.velocity, target, deltaTime, ticks)};
+        for (int tick = 0; tick < ticks && shots.Size() > 0 && !outcome.swept; ++tick)
+        {
+            MovementSystem(shots, deltaTime);
+            outcome.swept = PlayerCollisionSystem(players, enemies, bosses, shots, bombs, deltaTime) > 0;
+        }
+        return outcome;
+    }
+
+    // A burst emitter on an enemy just above the player, first due delay seconds in. At low tick rates several
+    // volleys fall due within one tick; every bullet is aimed at the player, so every one has to hit.
+    // Returns the hits and sets fired to the bullets emitted.
+    int EmitAtPlayer(Scalar delay, Scalar deltaTime, int ticks, int &fired)
+    {
+        PlayerArchetype players;
+        EnemyArchetype enemies;
+        BossArchetype bosses;
+        EmitterArchetype emitters;
+        ShotArchetype shots;
+        BombArchetype bombs;
+        SpawnPlayer(players, TARGET_X, TARGET_Y, 40, 40, Tuning());
+        Entity owner = SpawnEnemy(enemies, TARGET_X, TARGET_Y - 16, 1, RED, Tuning()); // Asleep, so it never rams the player
+        SpawnEmitter(emitters, owner, 0, 0, PATTERN_BURST, delay);
+
+        int hits = 0;
+        fired = 0;
+        for (int tick = 0; tick < ticks; ++tick)
+        {
+            size_t before = shots.Size();
+            EmitterSystem(emitters, enemies, players, shots, deltaTime);
+            fired += static_cast<int>(shots.Size() - before);
+            MovementSystem(shots, deltaTime);
+            // One hit per call; the pilot is put back each time so every bullet that reaches it counts
+            while (PlayerCollisionSystem(players, enemies, bosses, shots, bombs, deltaTime) > 0)
+            {
+                hits++;
+                players.Column<Pilot>()[0].exploding = false;
+            }
+        }
+        return hits;
+    }
+}
+
+int RunSweepTest()
+{
+    const int tickRates[] = {60, 30, 20, 15, 10, 5};
+    const Tuning tuning;
+    const Scalar graze = TARGET_HALF_WIDTH + SHOT_HALF_WIDTH - 1; // One pixel of overlap
+    const Scalar touch = TARGET_HALF_WIDTH + SHOT_HALF_WIDTH;     // Edges meet, which doesn't count as a hit
+    const Scalar spreadX = tuning.playerShotSpeed * Scalar(0.3f); // Outermost spread shot, roughly
+
+    // Player shots fly up into an enemy, enemy shots fly down into the player
+    const SweepCase enemyCases[] = {
+        {"shot centre", {0, -tuning.playerShotSpeed}, 0, true},
+        {"shot graze left", {0, -tuning.playerShotSpeed}, -graze, true},
+        {"shot graze right", {0, -tuning.playerShotSpeed}, graze, true},
+        {"shot touching edge", {0, -tuning.playerShotSpeed}, touch, false},
+        {"spread shot centre", {spreadX, -tuning.playerShotSpeed}, 0, true},
+    };
+    const SweepCase playerCases[] = {
+        {"enemy shot centre", {0, tuning.enemyShotSpeed}, 0, true},
+        {"enemy shot graze", {0, tuning.enemyShotSpeed}, -graze, true},
+        {"enemy shot touching edge", {0, tuning.enemyShotSpeed}, -touch, false},
+    };
+
+    std::printf("Swept collision against 20x20 targets, %d starting distances per case and tick rate\n", SWEEP_PHASES);
+    std::printf("%-26s %6s %8s %10s %10s %10s\n", "case", "Hz", "px/tick", "expected", "swept", "discrete");
+
+    int failures = 0;
+    for (int rate : tickRates)
+    {
+        const Scalar deltaTime = Scalar(1) / Scalar(rate);
+        for (int kind = 0; kind < 2; ++kind)
+        {
+            const SweepCase *cases = kind == 0 ? enemyCases : playerCases;
+            int caseCount = kind == 0 ? sizeof(enemyCases) / sizeof(enemyCases[0]) : sizeof(playerCases) / sizeof(playerCases[0]);
+            for (int c = 0; c < caseCount; ++c)
+            {
+                const SweepCase &sweep = cases[c];
+                int swept = 0;
+                int discrete = 0;
+                for (int phase = 0; phase < SWEEP_PHASES; ++phase)
+                {
+                    // Half a second out, plus a fraction of a tick so every alignment with the tick boundary comes up
+                    Scalar travel = Scalar(0.5f) + deltaTime * phase / SWEEP_PHASES;
+                    int ticks = rate + 2; // A second: past the target with room to spare
+                    SweepOutcome outcome = kind == 0 ? ShootEnemy(sweep, travel, deltaTime, ticks)
+                                                     : ShootPlayer(sweep, travel, deltaTime, ticks);
+                    swept += outcome.swept;
+                    discrete += outcome.discrete;
+                    if (outcome.swept != sweep.hits)
+                        failures++;
+                }
+                float step = ToFloat(Length(sweep.velocity.x, sweep.velocity.y) * deltaTime);
+                std::printf("%-26s %6d %8.1f %10d %10d %10d\n", sweep.name, rate, step, sweep.hits ? SWEEP_PHASES : 0,
+                            swept, discrete);
+            }
+        }
+
+        // Emitted bullets, which start between the muzzle and where they would be had they been fired on time
+        int fired = 0;
+        int hits = 0;
+        for (int phase = 0; phase < SWEEP_PHASES; ++phase)
+        {
+            int phaseFired;
+            hits += EmitAtPlayer(deltaTime * phase / SWEEP_PHASES, deltaTime, rate, phaseFired);
+            fired += phaseFired;
+        }
+        if (hits != fired)
+            failures++;
+        std::printf("%-26s %6d %8.1f %10d %10d %10s\n", "emitter burst catch-up", rate,
+                    ToFloat(GetPattern(PATTERN_BURST).speed * deltaTime), fired, hits, "-");
+    }
+
+    if (failures > 0)
+    {
+        std::printf("FAILED: %d runs where the swept result didn't match\n", failures);
+        return 1;
+    }
+    std::printf("All swept results match; the discrete column is what an end-of-tick overlap test would have caught\n");
+    return 0;
+}
@@ -0,0 +1,10 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// Headless micro-benchmarks and self-checks, run from the command line instead of the game.
+// Each prints a table to stdout and returns the process exit code.
+int RunSpatialBenchmark(); // --bench-spatial
+int RunBulletBenchmark();  // --bench-bullets
+int RunSweepTest();        // --test-sweep, exits with 1 if a projectile tunnels through its target
+
+#endif // BENCHMARK_H
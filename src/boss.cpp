@@ -0,0 +1,274 @@
+#include "boss.h"
+#include "collision.h"
+#include "emitter.h"
+#include <algorithm>
+
+namespace
+{
+    const int LEAF_PARTS = 2; // Parts per leaf before a node is split
+
+    Box Translate(const Box &box, Scalar dx, Scalar dy)
+    {
+        return {box.x + dx, box.y + dy, box.width, box.height};
+    }
+
+    // Top-down build: split on the longer axis at the median part centre
+    int BuildNode(BossHull &hull, int firstPart, int partCount)
+    {
+        int index = static_cast<int>(hull.nodes.size());
+        hull.nodes.push_back({hull.parts[firstPart].bounds, -1, -1, firstPart, partCount, false});
+
+        Box bounds = hull.parts[firstPart].bounds;
+        for (int i = firstPart + 1; i < firstPart + partCount; ++i)
+        {
+            bounds = Union(bounds, hull.parts[i].bounds);
+        }
+        hull.nodes[index].bounds = bounds;
+        if (partCount <= LEAF_PARTS)
+            return index;
+
+        bool splitX = bounds.width >= bounds.height;
+        auto begin = hull.parts.begin() + firstPart;
+        std::stable_sort(begin, begin + partCount, [splitX](const BossPart &a, const BossPart &b)
+                         { return splitX ? a.bounds.x * 2 + a.bounds.width < b.bounds.x * 2 + b.bounds.width
+                                         : a.bounds.y * 2 + a.bounds.height < b.bounds.y * 2 + b.bounds.height; });
+
+        int half = partCount / 2;
+        int left = BuildNode(hull, firstPart, half);
+        int right = BuildNode(hull, firstPart + half, partCount - half);
+        hull.nodes[index].left = left;
+        hull.nodes[index].right = right;
+        return index;
+    }
+
+    // Children come after their parent, so a reverse pass refits bottom-up
+    void Refit(BossHull &hull)
+    {
+        for (size_t i = hull.nodes.size(); i-- > 0;)
+        {
+            BvhNode &node = hull.nodes[i];
+            node.empty = true;
+            if (node.left < 0)
+            {
+                for (int p = node.firstPart; p < node.firstPart + node.partCount; ++p)
+                {
+                    if (hull.parts[p].health <= 0)
+                        continue;
+                    node.bounds = node.empty ? hull.parts[p].bounds : Union(node.bounds, hull.parts[p].bounds);
+                    node.empty = false;
+                }
+                continue;
+            }
+
+            const BvhNode &left = hull.nodes[node.left];
+            const BvhNode &right = hull.nodes[node.right];
+            if (!left.empty && !right.empty)
+                node.bounds = Union(left.bounds, right.bounds);
+            else if (!left.empty)
+                node.bounds = left.bounds;
+            else if (!right.empty)
+                node.bounds = right.bounds;
+            node.empty = left.empty && right.empty;
+        }
+    }
+
+    // Body stays centred on the boss position, so it covers the root bound symmetrically
+    void FitBody(const BossHull &hull, Body &body)
+    {
+        const Box &root = hull.nodes[0].bounds;
+        body.width = Max(-root.x, root.x + root.width) * 2;
+        body.height = Max(-root.y, root.y + root.height) * 2;
+    }
+
+    void AddPart(BossHull &hull, Scalar x, Scalar y, Scalar width, Scalar height, int health, Color color, bool core,
+                 EmitterArchetype &emitters, int pattern, Scalar delay)
+    {
+        Entity emitter = NO_ENTITY;
+        if (pattern >= 0)
+        {
+            emitter = SpawnEmitter(emitters, hull.owner, x, y + height / 2, pattern, delay);
+        }
+        hull.parts.push_back({{x - width / 2, y - height / 2, width, height}, health, health, color, core, emitter});
+    }
+}
+
+Entity SpawnBoss(EnemyArchetype &enemies, BossArchetype &bosses, EmitterArchetype &emitters, Scalar x, Scalar y, int level)
+{
+    EnemyBrain brain = {BOSS, 1.5f, 0, false, true};
+    Entity owner = enemies.Create({x, y}, {0, 0}, {0, 0}, {MAROON}, {0, 0}, brain);
+
+    // Armour under the core soaks shots from below, turrets and wings carry the guns.
+    // More guns every level; the delays let the boss fly in before it opens fire.
+    BossHull hull;
+    hull.owner = owner;
+    AddPart(hull, 0, 0, 60, 40, 20 + level * 10, MAROON, true, emitters, PATTERN_AIMED_FAN, 3);
+    AddPart(hull, 0, 30, 44, 14, 15, GRAY, false, emitters, -1, 0);
+    AddPart(hull, -40, 28, 24, 24, 10, RED, false, emitters, PATTERN_RING, 2);
+    AddPart(hull, 40, 28, 24, 24, 10, RED, false, emitters, level >= 3 ? PATTERN_BURST : PATTERN_RING, 2.8f);
+    AddPart(hull, -85, -4, 70, 28, 15, DARKPURPLE, false, emitters, level >= 2 ? PATTERN_SPIRAL : -1, 4);
+    AddPart(hull, 85, -4, 70, 28, 15, DARKPURPLE, false, emitters, level >= 2 ? PATTERN_SPIRAL : -1, 4);
+    AddPart(hull, -132, 2, 24, 20, 8, PURPLE, false, emitters, -1, 0);
+    AddPart(hull, 132, 2, 24, 20, 8, PURPLE, false, emitters, -1, 0);
+    BuildNode(hull, 0, static_cast<int>(hull.parts.size()));
+
+    Body &body = enemies.Get<Body>(owner);
+    Health &health = enemies.Get<Health>(owner);
+    FitBody(hull, body);
+    for (const BossPart &part : hull.parts)
+    {
+        health.value += part.health;
+    }
+    health.maxValue = health.value;
+
+    bosses.Create(hull);
+    return owner;
+}
+
+BossHull *FindHull(BossArchetype &bosses, Entity owner)
+{
+    for (BossHull &hull : bosses.Column<BossHull>())
+    {
+        if (hull.owner == owner)
+            return &hull;
+    }
+    return nullptr;
+}
+
+const BossHull *FindHull(const BossArchetype &bosses, Entity owner)
+{
+    for (const BossHull &hull : bosses.Column<BossHull>())
+    {
+        if (hull.owner == owner)
+            return &hull;
+    }
+    return nullptr;
+}
+
+bool SweepHull(const BossHull &hull, const Position &position, const Box &box, Scalar dx, Scalar dy,
+               Scalar &entryTime, int &part)
+{
+    // Work in the hull's local space
+    Box local = Translate(box, -position.x, -position.y);
+    Scalar bestTime = 2;
+    int bestPart = -1;
+    Scalar time;
+
+    int stack[32];
+    int depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        const BvhNode &node = hull.nodes[stack[--depth]];
+        if (node.empty || !SweepBox(local, dx, dy, node.bounds, time) || time >= bestTime)
+            continue;
+
+        if (node.left >= 0)
+        {
+            stack[depth++] = node.left;
+            stack[depth++] = node.right;
+            continue;
+        }
+        for (int p = node.firstPart; p < node.firstPart + node.partCount; ++p)
+        {
+            if (hull.parts[p].health > 0 && SweepBox(local, dx, dy, hull.parts[p].bounds, time) && time < bestTime)
+            {
+                bestTime = time;
+                bestPart = p;
+            }
+        }
+    }
+
+    if (bestPart < 0)
+        return false;
+    entryTime = bestTime;
+    part = bestPart;
+    return true;
+}
+
+bool OverlapsHull(const BossHull &hull, const Position &position, const Box &box)
+{
+    Box local = Translate(box, -position.x, -position.y);
+    int stack[32];
+    int depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        const BvhNode &node = hull.nodes[stack[--depth]];
+        if (node.empty || !Overlaps(local, node.bounds))
+            continue;
+
+        if (node.left >= 0)
+        {
+            stack[depth++] = node.left;
+            stack[depth++] = node.right;
+            continue;
+        }
+        for (int p = node.firstPart; p < node.firstPart + node.partCount; ++p)
+        {
+            if (hull.parts[p].health > 0 && Overlaps(local, hull.parts[p].bounds))
+                return true;
+        }
+    }
+    return false;
+}
+
+bool DamagePart(BossHull &hull, int part, Body &body, Health &health, EmitterArchetype &emitters)
+{
+    BossPart &hit = hull.parts[part];
+    hit.health--;
+    health.value--;
+    if (hit.health > 0)
+        return false;
+
+    if (hit.core)
+        return true;
+
+    // Part destroyed: silence its gun and shrink the hierarchy around what's left
+    emitters.Destroy(hit.emitter);
+    Refit(hull);
+    FitBody(hull, body);
+    return false;
+}
+
+void BossCleanupSystem(BossArchetype &bosses, const EnemyArchetype &enemies)
+{
+    const auto &hulls = bosses.Column<BossHull>();
+    bosses.RemoveIf([&](size_t i)
+                    { return !enemies.IsAlive(hulls[i].owner); });
+}
+
+void RenderBosses(const BossArchetype &bosses, const EnemyArchetype &enemies, const Box &viewport, RenderSnapshot &snapshot)
+{
+    for (const BossHull &hull : bosses.Column<BossHull>())
+    {
+        if (!enemies.IsAlive(hull.owner))
+            continue;
+
+        const Position &position = enemies.Get<Position>(hull.owner);
+        if (!Overlaps(viewport, GetBounds(position, enemies.Get<Body>(hull.owner))))
+            continue;
+        snapshot.entities.drawn++;
+        float x = ToFloat(position.x);
+        float y = ToFloat(position.y);
+        for (const BossPart &part : hull.parts)
+        {
+            if (part.health <= 0)
+                continue;
+            float left = x + ToFloat(part.bounds.x);
+            float top = y + ToFloat(part.bounds.y);
+            float width = ToFloat(part.bounds.width);
+            snapshot.AddRectangle(left, top, width, ToFloat(part.bounds.height), part.color);
+
+            // Per part health bar
+            float fraction = static_cast<float>(part.health) / part.maxHealth;
+            snapshot.AddRectangle(left, top - 4, width * fraction, 2, GREEN);
+        }
+
+        // Whole boss health across the top of its bound
+        const Health &health = enemies.Get<Health>(hull.owner);
+        const Body &body = enemies.Get<Body>(hull.owner);
+        float width = ToFloat(body.width);
+        float fraction = static_cast<float>(health.value) / health.maxValue;
+        snapshot.AddRectangle(x - width / 2, y - ToFloat(body.height) / 2 - 12, width * fraction, 4, LIME);
+    }
+}
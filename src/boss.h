@@ -0,0 +1,31 @@
+#ifndef BOSS_H
+#define BOSS_H
+
+#include "components.h"
+#include "snapshot.h"
+
+// Bosses are enemies (state BOSS) with a BossHull of independently destructible parts.
+// The enemy's Body always covers every live part, so it doubles as the root of the hierarchy.
+
+Entity SpawnBoss(EnemyArchetype &enemies, BossArchetype &bosses, EmitterArchetype &emitters, Scalar x, Scalar y, int level);
+
+// Hull of a boss enemy, nullptr when the enemy is not a boss
+BossHull *FindHull(BossArchetype &bosses, Entity owner);
+const BossHull *FindHull(const BossArchetype &bosses, Entity owner);
+
+// Sweeps a box moving by (dx, dy) against the live parts of a boss at position, descending only
+// into nodes the path touches. On a hit, entryTime and part describe the earliest part reached.
+bool SweepHull(const BossHull &hull, const Position &position, const Box &box, Scalar dx, Scalar dy,
+               Scalar &entryTime, int &part);
+bool OverlapsHull(const BossHull &hull, const Position &position, const Box &box);
+
+// Applies one hit to a part. Destroyed parts lose their emitter and the hierarchy is refit;
+// the boss's Body and Health follow. Returns true when the core went and the boss is destroyed.
+bool DamagePart(BossHull &hull, int part, Body &body, Health &health, EmitterArchetype &emitters);
+
+// Drops hulls whose boss is gone
+void BossCleanupSystem(BossArchetype &bosses, const EnemyArchetype &enemies);
+
+void RenderBosses(const BossArchetype &bosses, const EnemyArchetype &enemies, const Box &viewport, RenderSnapshot &snapshot);
+
+#endif // BOSS_H
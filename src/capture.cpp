@@ -0,0 +1,355 @@
+#include "capture.h"
+#include "fixed.h"
+#include "logger.h"
+#include <chrono>
+#include <cstring>
+
+// raylib loads OpenGL through GLFW but doesn't expose pixel buffer objects, so the few entry points
+// the readback needs are looked up the same way
+extern "C" void *glfwGetProcAddress(const char *name);
+
+namespace
+{
+#ifdef _WIN32
+#define CAPTURE_GL_API __stdcall
+#else
+#define CAPTURE_GL_API
+#endif
+
+    typedef struct GlSyncObject *GlSync;
+    typedef ptrdiff_t GlSizeiPtr;
+    typedef ptrdiff_t GlIntPtr;
+
+    const unsigned GL_UNSIGNED_BYTE_TYPE = 0x1401;
+    const unsigned GL_RGBA_FORMAT = 0x1908;
+    const unsigned GL_PIXEL_PACK_BUFFER = 0x88EB;
+    const unsigned GL_STREAM_READ = 0x88E1;
+    const unsigned GL_READ_FRAMEBUFFER = 0x8CA8;
+    const unsigned GL_MAP_READ_BIT = 0x0001;
+    const unsigned GL_SYNC_GPU_COMMANDS_COMPLETE = 0x9117;
+    const unsigned GL_ALREADY_SIGNALED = 0x911A;
+    const unsigned GL_CONDITION_SATISFIED = 0x911C;
+    const unsigned GL_SYNC_FLUSH_COMMANDS_BIT = 0x0001;
+    const uint64_t FENCE_TIMEOUT = 1000000000; // Nanoseconds; only hit if the driver has hung
+
+    struct GlFunctions
+    {
+        void(CAPTURE_GL_API *GenBuffers)(int, unsigned *);
+        void(CAPTURE_GL_API *DeleteBuffers)(int, const unsigned *);
+        void(CAPTURE_GL_API *BindBuffer)(unsigned, unsigned);
+        void(CAPTURE_GL_API *BufferData)(unsigned, GlSizeiPtr, const void *, unsigned);
+        void *(CAPTURE_GL_API *MapBufferRange)(unsigned, GlIntPtr, GlSizeiPtr, unsigned);
+        unsigned char(CAPTURE_GL_API *UnmapBuffer)(unsigned);
+        void(CAPTURE_GL_API *BindFramebuffer)(unsigned, unsigned);
+        void(CAPTURE_GL_API *ReadPixels)(int, int, int, int, unsigned, unsigned, void *);
+        GlSync(CAPTURE_GL_API *FenceSync)(unsigned, unsigned);
+        unsigned(CAPTURE_GL_API *ClientWaitSync)(GlSync, unsigned, uint64_t);
+        void(CAPTURE_GL_API *DeleteSync)(GlSync);
+    };
+
+    GlFunctions gl;
+
+    template <typename F>
+    bool Load(F &function, const char *name)
+    {
+        function = reinterpret_cast<F>(glfwGetProcAddress(name));
+        return function != nullptr;
+    }
+
+    bool LoadGlFunctions()
+    {
+        // Not short-circuited, so every entry point is looked up
+        bool loaded = true;
+        loaded &= Load(gl.GenBuffers, "glGenBuffers");
+        loaded &= Load(gl.DeleteBuffers, "glDeleteBuffers");
+        loaded &= Load(gl.BindBuffer, "glBindBuffer");
+        loaded &= Load(gl.BufferData, "glBufferData");
+        loaded &= Load(gl.MapBufferRange, "glMapBufferRange");
+        loaded &= Load(gl.UnmapBuffer, "glUnmapBuffer");
+        loaded &= Load(gl.BindFramebuffer, "glBindFramebuffer");
+        loaded &= Load(gl.ReadPixels, "glReadPixels");
+        loaded &= Load(gl.FenceSync, "glFenceSync");
+        loaded &= Load(gl.ClientWaitSync, "glClientWaitSync");
+        loaded &= Load(gl.DeleteSync, "glDeleteSync");
+        return loaded;
+    }
+
+    // Full range BT.601, the "C420jpeg" colour space in the Y4M header
+    unsigned char Luma(int r, int g, int b)
+    {
+        return static_cast<unsigned char>((77 * r + 150 * g + 29 * b + 128) >> 8);
+    }
+
+    unsigned char ChromaBlue(int r, int g, int b)
+    {
+        return static_cast<unsigned char>(Clamp((-43 * r - 85 * g + 128 * b + 128) / 256 + 128, 0, 255));
+    }
+
+    unsigned char ChromaRed(int r, int g, int b)
+    {
+        return static_cast<unsigned char>(Clamp((128 * r - 107 * g - 21 * b + 128) / 256 + 128, 0, 255));
+    }
+}
+
+VideoCapture::VideoCapture()
+    : y4m(false), width(0), height(0), framesPerSecond(0), capturing(false), asyncReadback(false),
+      framesRead(0), framesCollected(0), framesDropped(0), framesSkipped(0), readbackStalls(0), quit(false), file(nullptr)
+{
+    for (PixelBuffer &pixelBuffer : pixelBuffers)
+    {
+        pixelBuffer = {0, nullptr, 0};
+    }
+}
+
+VideoCapture::~VideoCapture()
+{
+    Stop();
+}
+
+bool VideoCapture::Start(const std::string &path, int width, int height, int framesPerSecond)
+{
+    this->path = path;
+    this->width = width;
+    this->height = height;
+    this->framesPerSecond = framesPerSecond;
+    y4m = path.size() >= 4 && path.compare(path.size() - 4, 4, ".y4m") == 0;
+
+    if (y4m)
+    {
+        file = fopen(path.c_str(), "wb");
+        if (!file)
+            return false;
+        fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, framesPerSecond);
+    }
+
+    size_t frameBytes = static_cast<size_t>(width) * height * 4;
+    for (int i = 0; i < FRAME_COUNT; ++i)
+    {
+        frames[i].resize(frameBytes);
+        freeFrames.Push(i);
+    }
+    scratch.resize(frameBytes);
+
+    asyncReadback = LoadGlFunctions() && CreatePixelBuffers();
+    if (!asyncReadback)
+        LOG_WARNING("pixel buffer readback unavailable, capture reads frames back synchronously");
+
+    quit = false;
+    worker = std::thread(&VideoCapture::RunWorker, this);
+    capturing = true;
+    LOG_INFO("capturing", {{"width", width}, {"height", height}, {"path", path}});
+    return true;
+}
+
+bool VideoCapture::CreatePixelBuffers()
+{
+    GlSizeiPtr frameBytes = static_cast<GlSizeiPtr>(width) * height * 4;
+    for (PixelBuffer &pixelBuffer : pixelBuffers)
+    {
+        gl.GenBuffers(1, &pixelBuffer.buffer);
+        if (pixelBuffer.buffer == 0)
+            return false;
+        gl.BindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer.buffer);
+        gl.BufferData(GL_PIXEL_PACK_BUFFER, frameBytes, nullptr, GL_STREAM_READ);
+    }
+    gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
+
+void VideoCapture::DestroyPixelBuffers()
+{
+    for (PixelBuffer &pixelBuffer : pixelBuffers)
+    {
+        if (pixelBuffer.fence)
+            gl.DeleteSync(static_cast<GlSync>(pixelBuffer.fence));
+        if (pixelBuffer.buffer)
+            gl.DeleteBuffers(1, &pixelBuffer.buffer);
+        pixelBuffer = {0, nullptr, 0};
+    }
+}
+
+void VideoCapture::CaptureFrame(RenderTexture2D target)
+{
+    if (!capturing)
+        return;
+    if (target.texture.width != width || target.texture.height != height)
+    {
+        framesSkipped++;
+        return;
+    }
+
+    if (!asyncReadback)
+    {
+        Image image = LoadImageFromTexture(target.texture);
+        Submit(static_cast<const unsigned char *>(image.data), framesRead++);
+        UnloadImage(image);
+        return;
+    }
+
+    // Hand finished readbacks to the worker, oldest first so frames stay in order
+    while (framesCollected < framesRead && Collect(pixelBuffers[framesCollected % PBO_COUNT], false))
+    {
+    }
+    // Every buffer still in flight: wait for the oldest. Three frames back it has almost always finished.
+    if (framesRead - framesCollected == PBO_COUNT)
+    {
+        readbackStalls++;
+        Collect(pixelBuffers[framesCollected % PBO_COUNT], true);
+    }
+
+    // Queue the copy into a pixel buffer; glReadPixels returns without waiting for it
+    PixelBuffer &pixelBuffer = pixelBuffers[framesRead % PBO_COUNT];
+    gl.BindFramebuffer(GL_READ_FRAMEBUFFER, target.id);
+    gl.BindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer.buffer);
+    gl.ReadPixels(0, 0, width, height, GL_RGBA_FORMAT, GL_UNSIGNED_BYTE_TYPE, nullptr);
+    pixelBuffer.fence = gl.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pixelBuffer.frame = framesRead++;
+    gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    gl.BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+bool VideoCapture::Collect(PixelBuffer &pixelBuffer, bool wait)
+{
+    unsigned status = gl.ClientWaitSync(static_cast<GlSync>(pixelBuffer.fence), GL_SYNC_FLUSH_COMMANDS_BIT,
+                                        wait ? FENCE_TIMEOUT : 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED && !wait)
+        return false;
+    gl.DeleteSync(static_cast<GlSync>(pixelBuffer.fence));
+    pixelBuffer.fence = nullptr;
+
+    gl.BindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer.buffer);
+    void *pixels = gl.MapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GlSizeiPtr>(width) * height * 4, GL_MAP_READ_BIT);
+    if (pixels)
+    {
+        Submit(static_cast<const unsigned char *>(pixels), pixelBuffer.frame);
+        gl.UnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    framesCollected++;
+    return true;
+}
+
+void VideoCapture::Submit(const unsigned char *pixels, unsigned long frame)
+{
+    int index;
+    if (!freeFrames.Pop(index))
+    {
+        framesDropped++; // Worker is behind; dropping keeps the game loop from waiting on the disk
+        return;
+    }
+    memcpy(frames[index].data(), pixels, frames[index].size());
+    frameNumbers[index] = frame;
+    readyFrames.Push(index);
+}
+
+void VideoCapture::Stop()
+{
+    if (!capturing)
+        return;
+
+    if (asyncReadback)
+    {
+        while (framesCollected < framesRead)
+        {
+            Collect(pixelBuffers[framesCollected % PBO_COUNT], true);
+        }
+        DestroyPixelBuffers();
+    }
+
+    quit = true;
+    worker.join();
+    if (file)
+    {
+        fclose(file);
+        file = nullptr;
+    }
+    capturing = false;
+    LOG_INFO("capture finished", {{"written", framesRead - framesDropped}, {"dropped", framesDropped},
+                                  {"skipped", framesSkipped}, {"readbackStalls", readbackStalls}});
+}
+
+void VideoCapture::RunWorker()
+{
+    while (true)
+    {
+        int index;
+        if (!readyFrames.Pop(index))
+        {
+            if (quit)
+                break; // The game thread has stopped submitting, so empty means done
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            continue;
+        }
+
+        if (y4m)
+            WriteY4m(frames[index].data());
+        else
+            WritePng(frames[index].data(), frameNumbers[index]);
+        freeFrames.Push(index);
+    }
+}
+
+void VideoCapture::WriteY4m(const unsigned char *pixels)
+{
+    // 4:2:0 planes: full size luma, then quarter size blue and red chroma
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    unsigned char *luma = scratch.data();
+    unsigned char *blue = luma + width * height;
+    unsigned char *red = blue + chromaWidth * chromaHeight;
+
+    for (int y = 0; y < height; ++y)
+    {
+        const unsigned char *row = pixels + static_cast<size_t>(height - 1 - y) * width * 4; // GL rows are bottom up
+        for (int x = 0; x < width; ++x)
+        {
+            luma[y * width + x] = Luma(row[x * 4], row[x * 4 + 1], row[x * 4 + 2]);
+        }
+    }
+    for (int y = 0; y < chromaHeight; ++y)
+    {
+        for (int x = 0; x < chromaWidth; ++x)
+        {
+            // Average each 2x2 block, clamped at odd edges
+            int r = 0, g = 0, b = 0;
+            for (int dy = 0; dy < 2; ++dy)
+            {
+                int sourceY = Min(y * 2 + dy, height - 1);
+                const unsigned char *row = pixels + static_cast<size_t>(height - 1 - sourceY) * width * 4;
+                for (int dx = 0; dx < 2; ++dx)
+                {
+                    const unsigned char *pixel = row + Min(x * 2 + dx, width - 1) * 4;
+                    r += pixel[0];
+                    g += pixel[1];
+                    b += pixel[2];
+                }
+            }
+            blue[y * chromaWidth + x] = ChromaBlue(r / 4, g / 4, b / 4);
+            red[y * chromaWidth + x] = ChromaRed(r / 4, g / 4, b / 4);
+        }
+    }
+
+    fputs("FRAME\n", file);
+    fwrite(scratch.data(), 1, width * height + 2 * chromaWidth * chromaHeight, file);
+}
+
+void VideoCapture::WritePng(const unsigned char *pixels, unsigned long frame)
+{
+    // Flip to top row first and make every pixel opaque; blending leaves alpha below 255 in places
+    size_t rowBytes = static_cast<size_t>(width) * 4;
+    for (int y = 0; y < height; ++y)
+    {
+        unsigned char *row = scratch.data() + y * rowBytes;
+        memcpy(row, pixels + (height - 1 - y) * rowBytes, rowBytes);
+        for (int x = 0; x < width; ++x)
+        {
+            row[x * 4 + 3] = 255;
+        }
+    }
+
+    // Not TextFormat: its buffers are shared with the game thread
+    char fileName[512];
+    snprintf(fileName, sizeof(fileName), "%s%06lu.png", path.c_str(), frame);
+    Image image = {scratch.data(), width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+    ExportImage(image, fileName);
+}
@@ -0,0 +1,68 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <raylib.h>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "memory.h"
+#include "spsc_ring.h"
+
+// Records the render target to disk without stalling the frame. Each frame is read back into a
+// pixel buffer object, mapped a few frames later once its fence has signalled, and converted and
+// written by a worker thread. When the worker falls behind frames are dropped, never waited for.
+class VideoCapture
+{
+public:
+    VideoCapture();
+    ~VideoCapture();
+    // A path ending in .y4m writes one YUV4MPEG2 video; anything else is a prefix for numbered PNGs
+    bool Start(const std::string &path, int width, int height, int framesPerSecond);
+    void CaptureFrame(RenderTexture2D target); // Call after EndTextureMode, with the GL context current
+    void Stop();                                // Finishes in-flight frames; also needs the GL context
+    bool IsCapturing() const { return capturing; }
+
+private:
+    static const int PBO_COUNT = 3;   // Readbacks in flight
+    static const int FRAME_COUNT = 8; // Frames queued for the worker
+
+    struct PixelBuffer
+    {
+        unsigned int buffer;
+        void *fence;
+        unsigned long frame;
+    };
+
+    std::string path;
+    bool y4m;
+    int width;
+    int height;
+    int framesPerSecond;
+    bool capturing;
+    bool asyncReadback; // False when the GL entry points for PBOs and fences aren't available
+    PixelBuffer pixelBuffers[PBO_COUNT];
+    unsigned long framesRead;      // Frames handed to a pixel buffer
+    unsigned long framesCollected; // Frames mapped back out of one
+    unsigned long framesDropped;   // No free frame for the worker to take
+    unsigned long framesSkipped;   // Render target was not at capture size (dynamic resolution)
+    unsigned long readbackStalls;  // Had to wait for a fence to reuse its buffer
+    TrackedVector<unsigned char, MEMORY_RENDERING> frames[FRAME_COUNT]; // RGBA, bottom row first
+    unsigned long frameNumbers[FRAME_COUNT];
+    SpscRing<int, FRAME_COUNT> freeFrames;  // Worker -> game thread
+    SpscRing<int, FRAME_COUNT> readyFrames; // Game thread -> worker
+    std::thread worker;
+    std::atomic<bool> quit;
+    FILE *file; // Only for Y4M
+    TrackedVector<unsigned char, MEMORY_RENDERING> scratch; // Worker-side conversion buffer
+
+    bool CreatePixelBuffers();
+    void DestroyPixelBuffers();
+    bool Collect(PixelBuffer &pixelBuffer, bool wait); // False if the readback isn't finished and wait is false
+    void Submit(const unsigned char *pixels, unsigned long frame);
+    void RunWorker();
+    void WriteY4m(const unsigned char *pixels);
+    void WritePng(const unsigned char *pixels, unsigned long frame);
+};
+
+#endif // CAPTURE_H
@@ -0,0 +1,56 @@
+#include "collision.h"
+
+namespace
+{
+    Scalar Abs(Scalar value)
+    {
+        return value < 0 ? -value : value;
+    }
+
+    // distance / speed, saturated outside [-2, 2] so fixed-point division can't overflow.
+    // Only times within [0, 1] matter to the caller.
+    Scalar SlabTime(Scalar distance, Scalar speed)
+    {
+        if (Abs(distance) >= Abs(speed) * 2)
+            return ((distance < 0) == (speed < 0)) ? Scalar(2) : Scalar(-2);
+        return distance / speed;
+    }
+
+    // Narrows [entry, exit] to the part of the move where the box overlaps the target along one axis
+    bool ClipAxis(Scalar origin, Scalar delta, Scalar slabMin, Scalar slabMax, Scalar &entry, Scalar &exit)
+    {
+        if (delta == 0)
+        {
+            return origin > slabMin && origin < slabMax;
+        }
+
+        Scalar t1 = SlabTime(slabMin - origin, delta);
+        Scalar t2 = SlabTime(slabMax - origin, delta);
+        if (t1 > t2)
+        {
+            Scalar swap = t1;
+            t1 = t2;
+            t2 = swap;
+        }
+        entry = Max(entry, t1);
+        exit = Min(exit, t2);
+        return entry < exit;
+    }
+}
+
+bool SweepBox(const Box &box, Scalar dx, Scalar dy, const Box &target, Scalar &entryTime)
+{
+    // Grow the target by the moving box (Minkowski sum) and cast the box's corner through it
+    Scalar minX = target.x - box.width;
+    Scalar maxX = target.x + target.width;
+    Scalar minY = target.y - box.height;
+    Scalar maxY = target.y + target.height;
+
+    Scalar entry = 0;
+    Scalar exit = 1;
+    if (!ClipAxis(box.x, dx, minX, maxX, entry, exit) || !ClipAxis(box.y, dy, minY, maxY, entry, exit))
+        return false;
+
+    entryTime = entry;
+    return true;
+}
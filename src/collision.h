@@ -0,0 +1,18 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "components.h"
+
+// Continuous collision: does the box, moving by (dx, dy) over the tick, touch the stationary target?
+// On a hit, entryTime is the fraction of the move (0..1) at which they first overlap.
+// Uses the same strict overlap rule as Overlaps, so touching edges do not count.
+bool SweepBox(const Box &box, Scalar dx, Scalar dy, const Box &target, Scalar &entryTime);
+
+// Box the entity occupied at the start of this tick, given it has already moved by velocity * deltaTime
+inline Box GetPreviousBounds(const Position &position, const Velocity &velocity, const Body &body, Scalar deltaTime)
+{
+    Position previous = {position.x - velocity.x * deltaTime, position.y - velocity.y * deltaTime};
+    return GetBounds(previous, body);
+}
+
+#endif // COLLISION_H
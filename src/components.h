@@ -0,0 +1,178 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <raylib.h>
+#include "ecs.h"
+#include "fixed.h"
+
+enum EnemyState
+{
+    ENTERING,
+    FORMATION,
+    ATTACKING,
+    BOSS // Flies in, then holds the top of the screen while its emitters fire
+};
+
+enum WeaponMode
+{
+    WEAPON_NORMAL,
+    WEAPON_SPREAD, // Fan of shots
+    WEAPON_HOMING  // Regular shots plus missiles that chase the nearest enemy
+};
+
+struct Position
+{
+    Scalar x;
+    Scalar y;
+};
+
+struct Velocity
+{
+    Scalar x; // Pixels per second
+    Scalar y;
+};
+
+struct Body
+{
+    Scalar width; // Collision box centred on the position
+    Scalar height;
+};
+
+struct Health
+{
+    int value;    // Hits left before the entity is destroyed
+    int maxValue;
+};
+
+struct Tint
+{
+    Color color;
+};
+
+struct Weapon
+{
+    Scalar cooldown;          // Time between shots
+    Scalar timeSinceLastShot; // Time since the last shot; enemies fire on timers instead
+};
+
+struct EnemyBrain
+{
+    EnemyState state;           // Current state of the enemy
+    Scalar speed;
+    Scalar movementPatternTime; // Time for movement pattern
+    bool dropsBombs;            // Purple enemies drop bombs instead of shooting
+    bool asleep;                // Still wholly above the screen, so left out of collision queries
+};
+
+struct Fuse
+{
+    bool exploded;
+    Scalar explosionTime; // Time since the bomb exploded
+};
+
+struct Pilot
+{
+    Scalar movementSpeed;
+    int lives;
+    bool exploding;       // Explosion state
+    Scalar explosionTime; // Time since explosion
+    bool shootFromLeft;   // Flag to alternate shooting sides
+    Scalar spriteWidth;   // Player texture size, drives drawing and cannon placement
+    Scalar spriteHeight;
+    WeaponMode weaponMode;
+    Scalar weaponTime;    // Time left on the current power-up
+};
+
+struct Homing
+{
+    Scalar speed;
+    Scalar turnRate; // How quickly velocity swings towards the target, per second
+};
+
+struct PowerUp
+{
+    WeaponMode weaponMode; // Weapon granted on pickup
+};
+
+struct Emitter
+{
+    Entity owner;    // Enemy the emitter is mounted on; the emitter goes when it does
+    Scalar offsetX;  // Mount point relative to the owner
+    Scalar offsetY;
+    int pattern;     // PatternId, see emitter.h
+    Scalar timer;    // Time until the next volley
+    Scalar angle;    // Current rotation, advanced by the pattern's spin
+    int volleysLeft; // Volleys left in the current burst
+};
+
+// Axis aligned box in simulation units
+struct Box
+{
+    Scalar x;
+    Scalar y;
+    Scalar width;
+    Scalar height;
+};
+
+// Same test as CheckCollisionRecs, kept in simulation units so fixed-point builds stay exact
+inline bool Overlaps(const Box &a, const Box &b)
+{
+    return a.x < b.x + b.width && a.x + a.width > b.x && a.y < b.y + b.height && a.y + a.height > b.y;
+}
+
+// Collision box of an entity
+inline Box GetBounds(const Position &position, const Body &body)
+{
+    return {position.x - body.width / 2, position.y - body.height / 2, body.width, body.height};
+}
+
+// Smallest box holding both
+inline Box Union(const Box &a, const Box &b)
+{
+    Scalar left = Min(a.x, b.x);
+    Scalar top = Min(a.y, b.y);
+    return {left, top, Max(a.x + a.width, b.x + b.width) - left, Max(a.y + a.height, b.y + b.height) - top};
+}
+
+// One destructible piece of a boss, with its own hitbox
+struct BossPart
+{
+    Box bounds;     // Relative to the boss position
+    int health;
+    int maxHealth;
+    Color color;
+    bool core;      // Destroying the core destroys the boss
+    Entity emitter; // Emitter mounted on this part, NO_ENTITY when unarmed
+};
+
+// Node of a boss's bounding volume hierarchy, in the same local space as its parts
+struct BvhNode
+{
+    Box bounds;    // Refit as parts are destroyed
+    int left;      // Child nodes, -1 for leaves
+    int right;
+    int firstPart; // Leaves own parts [firstPart, firstPart + partCount)
+    int partCount;
+    bool empty;    // Every part below is destroyed
+};
+
+// Parts and hierarchy of a boss. The boss itself is an enemy whose Body is the root bound,
+// so a projectile that misses it is rejected in one test and only hits descend into the tree.
+struct BossHull
+{
+    Entity owner; // Boss enemy
+    TrackedVector<BossPart, MEMORY_ENTITIES> parts;
+    TrackedVector<BvhNode, MEMORY_ENTITIES> nodes; // nodes[0] is the root, children always come after their parent
+};
+
+// Every entity kind is one archetype; adding a kind means adding a typedef and listing it in the systems
+typedef Archetype<MEMORY_ENTITIES, Position, Body, Weapon, Pilot> PlayerArchetype;
+typedef Archetype<MEMORY_ENTITIES, Position, Body, Health, Tint, Weapon, EnemyBrain> EnemyArchetype;
+typedef Archetype<MEMORY_PROJECTILES, Position, Velocity, Body, Tint> ShotArchetype;
+typedef Archetype<MEMORY_PROJECTILES, Position, Velocity, Body, Fuse> BombArchetype;
+typedef Archetype<MEMORY_PROJECTILES, Position, Velocity, Body, Tint, Homing> MissileArchetype; // Expire on a timer
+typedef Archetype<MEMORY_ENTITIES, Position, Velocity, Body, PowerUp> PowerUpArchetype;
+typedef Archetype<MEMORY_ENTITIES, Position, Emitter> EmitterArchetype;
+typedef Archetype<MEMORY_ENTITIES, BossHull> BossArchetype;
+
+#endif // COMPONENTS_H
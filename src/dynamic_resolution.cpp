@@ -0,0 +1,111 @@
+#include "dynamic_resolution.h"
+
+namespace
+{
+    // Available render scales, highest quality first
+    const float SCALE_LEVELS[] = {1.0f, 0.85f, 0.7f, 0.6f, 0.5f};
+    const int NUM_SCALE_LEVELS = sizeof(SCALE_LEVELS) / sizeof(SCALE_LEVELS[0]);
+
+    const float SMOOTHING = 0.1f;          // Weight of the newest sample in the moving averages
+    const float DOWNSCALE_RATIO = 1.1f;    // Step down when frames run 10% over budget
+    const float UPSCALE_RATIO = 0.6f;      // Step up when work fits in 60% of the budget
+    const int MIN_FRAMES_BETWEEN = 30;     // Let the averages settle after every change
+    const int BASE_UPGRADE_DELAY = 120;    // Headroom frames needed before stepping up
+    const int MAX_UPGRADE_DELAY = 1200;    // Cap for the backoff after a failed step up
+}
+
+DynamicResolution::DynamicResolution(int virtualWidth, int virtualHeight, float targetFrameTime)
+    : virtualWidth(virtualWidth), virtualHeight(virtualHeight), targetFrameTime(targetFrameTime), enabled(false),
+      levelIndex(0), avgFrameTime(targetFrameTime), avgWorkTime(0.0f), framesSinceChange(0),
+      upgradeDelay(BASE_UPGRADE_DELAY), failedUpgradeLevel(-1), lastChangeUpgraded(false)
+{
+}
+
+void DynamicResolution::Update(float frameTime, float workTime)
+{
+    if (!enabled)
+        return;
+
+    avgFrameTime += (frameTime - avgFrameTime) * SMOOTHING;
+    avgWorkTime += (workTime - avgWorkTime) * SMOOTHING;
+    framesSinceChange++;
+
+    if (framesSinceChange < MIN_FRAMES_BETWEEN)
+        return;
+
+    // An upgrade that held through the backoff window means the spike behind it has passed, so ease the
+    // backoff off again instead of keeping it for the rest of the session
+    if (lastChangeUpgraded && framesSinceChange >= upgradeDelay)
+    {
+        lastChangeUpgraded = false;
+        upgradeDelay = (upgradeDelay / 2 > BASE_UPGRADE_DELAY) ? upgradeDelay / 2 : BASE_UPGRADE_DELAY;
+        if (upgradeDelay == BASE_UPGRADE_DELAY || levelIndex <= failedUpgradeLevel)
+        {
+            upgradeDelay = BASE_UPGRADE_DELAY;
+            failedUpgradeLevel = -1;
+        }
+    }
+
+    if (avgFrameTime > targetFrameTime * DOWNSCALE_RATIO && levelIndex < NUM_SCALE_LEVELS - 1)
+    {
+        // Dropping straight after an upgrade means that level is too expensive, so back off
+        // before trying it again instead of oscillating between the two sizes. A second step down
+        // while the load is still rising says nothing about the level above.
+        if (lastChangeUpgraded && framesSinceChange < upgradeDelay)
+        {
+            failedUpgradeLevel = levelIndex;
+            upgradeDelay = (upgradeDelay * 2 < MAX_UPGRADE_DELAY) ? upgradeDelay * 2 : MAX_UPGRADE_DELAY;
+        }
+        SetLevel(levelIndex + 1);
+    }
+    else if (levelIndex > 0 && avgFrameTime <= targetFrameTime * 1.02f && avgWorkTime < targetFrameTime * UPSCALE_RATIO)
+    {
+        int delay = (levelIndex - 1 == failedUpgradeLevel) ? upgradeDelay : BASE_UPGRADE_DELAY;
+        if (framesSinceChange >= delay)
+        {
+            SetLevel(levelIndex - 1);
+        }
+    }
+}
+
+void DynamicResolution::SetEnabled(bool enabled)
+{
+    this->enabled = enabled;
+    if (!enabled)
+    {
+        // Go back to full resolution and forget the history
+        SetLevel(0);
+        upgradeDelay = BASE_UPGRADE_DELAY;
+        failedUpgradeLevel = -1;
+        lastChangeUpgraded = false;
+    }
+}
+
+bool DynamicResolution::IsEnabled() const
+{
+    return enabled;
+}
+
+float DynamicResolution::GetScale() const
+{
+    return SCALE_LEVELS[levelIndex];
+}
+
+int DynamicResolution::GetWidth() const
+{
+    return static_cast<int>(virtualWidth * GetScale());
+}
+
+int DynamicResolution::GetHeight() const
+{
+    return static_cast<int>(virtualHeight * GetScale());
+}
+
+void DynamicResolution::SetLevel(int index)
+{
+    lastChangeUpgraded = index < levelIndex;
+    levelIndex = index;
+    framesSinceChange = 0;
+    avgFrameTime = targetFrameTime;
+    avgWorkTime = 0.0f;
+}
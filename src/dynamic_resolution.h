@@ -0,0 +1,33 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+// Picks the internal render target size from measured frame times.
+// Frames that overrun the budget step the scale down; sustained headroom steps it back up.
+class DynamicResolution
+{
+public:
+    DynamicResolution(int virtualWidth, int virtualHeight, float targetFrameTime);
+    void Update(float frameTime, float workTime); // Feed last frame's interval and CPU work time
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const;
+    float GetScale() const;
+    int GetWidth() const;  // Render target width at the current scale
+    int GetHeight() const; // Render target height at the current scale
+
+private:
+    int virtualWidth;
+    int virtualHeight;
+    float targetFrameTime;
+    bool enabled;
+    int levelIndex;          // Index into the scale level table
+    float avgFrameTime;      // Smoothed frame interval
+    float avgWorkTime;       // Smoothed CPU time spent before presenting
+    int framesSinceChange;   // Frames since the last scale change
+    int upgradeDelay;        // Frames of headroom required before stepping up
+    int failedUpgradeLevel;  // Level we last had to drop back from, -1 if none
+    bool lastChangeUpgraded; // The last scale change stepped up and hasn't yet held for upgradeDelay frames
+
+    void SetLevel(int index);
+};
+
+#endif // DYNAMIC_RESOLUTION_H
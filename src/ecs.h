@@ -0,0 +1,197 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "memory.h"
+
+// Stable handle to an entity: slot index plus a generation that changes when the slot is reused
+struct Entity
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
+inline bool operator==(Entity a, Entity b) { return a.index == b.index && a.generation == b.generation; }
+inline bool operator!=(Entity a, Entity b) { return !(a == b); }
+
+const Entity NO_ENTITY = {0xFFFFFFFFu, 0};
+
+// Dense storage for every entity that has exactly this set of components.
+// Each component type lives in its own tightly packed column, so systems walk memory linearly.
+// Removal swaps the last row into the hole, so row order is not stable but Entity handles are.
+// All storage is reported to the archetype's memory tag.
+template <MemoryTag Tag, typename... Components>
+class Archetype
+{
+public:
+    Entity Create(const Components &...components)
+    {
+        Entity entity = AllocateEntity();
+        int expand[] = {0, (std::get<TrackedVector<Components, Tag>>(columns).push_back(components), 0)...};
+        (void)expand;
+        return entity;
+    }
+
+    // Appends count default rows in one go and returns the first new row.
+    // The caller fills the columns directly, which keeps bulk spawns (bullet patterns) to tight loops.
+    size_t CreateMany(size_t count)
+    {
+        size_t first = entities.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            AllocateEntity();
+        }
+        int expand[] = {0, (std::get<TrackedVector<Components, Tag>>(columns).resize(first + count), 0)...};
+        (void)expand;
+        return first;
+    }
+
+    // Appends copies of every row of source as new entities and returns the first new row.
+    // Entity handles into source don't carry over.
+    size_t Append(const Archetype &source)
+    {
+        size_t first = CreateMany(source.Size());
+        int expand[] = {0, (std::copy(std::get<TrackedVector<Components, Tag>>(source.columns).begin(),
+                                      std::get<TrackedVector<Components, Tag>>(source.columns).end(),
+                                      std::get<TrackedVector<Components, Tag>>(columns).begin() + first), 0)...};
+        (void)expand;
+        return first;
+    }
+
+    void Remove(size_t row)
+    {
+        size_t last = entities.size() - 1;
+        Entity removed = entities[row];
+        if (row != last)
+        {
+            entities[row] = entities[last];
+            slots[entities[row].index].row = static_cast<uint32_t>(row);
+            int expand[] = {0, (MoveRow(std::get<TrackedVector<Components, Tag>>(columns), row, last), 0)...};
+            (void)expand;
+        }
+        entities.pop_back();
+        int expand[] = {0, (std::get<TrackedVector<Components, Tag>>(columns).pop_back(), 0)...};
+        (void)expand;
+
+        slots[removed.index].generation++;
+        freeSlots.push_back(removed.index);
+    }
+
+    void Destroy(Entity entity)
+    {
+        if (IsAlive(entity))
+            Remove(slots[entity.index].row);
+    }
+
+    // Removes every row the predicate returns true for and returns how many; the predicate receives the row index
+    template <typename Predicate>
+    size_t RemoveIf(Predicate predicate)
+    {
+        // Walk backwards so the row swapped into a hole has already been visited
+        size_t removed = 0;
+        for (size_t row = entities.size(); row-- > 0;)
+        {
+            if (predicate(row))
+            {
+                Remove(row);
+                removed++;
+            }
+        }
+        return removed;
+    }
+
+    void Clear()
+    {
+        while (!entities.empty())
+            Remove(entities.size() - 1);
+    }
+
+    bool IsAlive(Entity entity) const
+    {
+        return entity.index < slots.size() && slots[entity.index].generation == entity.generation;
+    }
+
+    size_t Size() const { return entities.size(); }
+    bool Empty() const { return entities.empty(); }
+    Entity GetEntity(size_t row) const { return entities[row]; }
+    size_t GetRow(Entity entity) const { return slots[entity.index].row; }
+
+    template <typename C>
+    TrackedVector<C, Tag> &Column() { return std::get<TrackedVector<C, Tag>>(columns); }
+
+    template <typename C>
+    const TrackedVector<C, Tag> &Column() const { return std::get<TrackedVector<C, Tag>>(columns); }
+
+    template <typename C>
+    C &Get(Entity entity) { return Column<C>()[GetRow(entity)]; }
+
+    template <typename C>
+    const C &Get(Entity entity) const { return Column<C>()[GetRow(entity)]; }
+
+    // Every row plus the slot bookkeeping, so Entity handles held elsewhere survive a save and load.
+    // The archive needs Write/Read overloads for TrackedVector of each component type.
+    template <typename Writer>
+    void Save(Writer &writer) const
+    {
+        int expand[] = {0, (writer.Write(std::get<TrackedVector<Components, Tag>>(columns)), 0)...};
+        (void)expand;
+        writer.Write(entities);
+        writer.Write(slots);
+        writer.Write(freeSlots);
+    }
+
+    template <typename Reader>
+    void Load(Reader &reader)
+    {
+        int expand[] = {0, (reader.Read(std::get<TrackedVector<Components, Tag>>(columns)), 0)...};
+        (void)expand;
+        reader.Read(entities);
+        reader.Read(slots);
+        reader.Read(freeSlots);
+    }
+
+private:
+    struct Slot
+    {
+        uint32_t row;
+        uint32_t generation;
+    };
+
+    std::tuple<TrackedVector<Components, Tag>...> columns;
+    TrackedVector<Entity, Tag> entities; // Row -> entity
+    TrackedVector<Slot, Tag> slots;      // Entity index -> row
+    TrackedVector<uint32_t, Tag> freeSlots;
+
+    // Hands out a slot and appends the entity; the caller appends the components
+    Entity AllocateEntity()
+    {
+        uint32_t slot;
+        if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            slot = static_cast<uint32_t>(slots.size());
+            slots.push_back({0, 0});
+        }
+        slots[slot].row = static_cast<uint32_t>(entities.size());
+
+        Entity entity = {slot, slots[slot].generation};
+        entities.push_back(entity);
+        return entity;
+    }
+
+    template <typename C>
+    static void MoveRow(TrackedVector<C, Tag> &column, size_t to, size_t from)
+    {
+        column[to] = column[from];
+    }
+};
+
+#endif // ECS_H
@@ -0,0 +1,151 @@
+#include "emitter.h"
+
+namespace
+{
+    const Scalar FULL_TURN = 6.2831853f;
+    const Scalar BULLET_SIZE = 8;
+    const int MAX_VOLLEYS_PER_TICK = 16; // Catch-up limit when a tick spans several volleys
+
+    const EmitterPattern PATTERNS[PATTERN_COUNT] = {
+        // aim, bullets, arc, spin, speed, interval, burst, burstInterval, color
+        {AIM_DOWN, 24, FULL_TURN, 0.13f, 200, 1.6f, 1, 0, ORANGE},     // PATTERN_RING
+        {AIM_DOWN, 4, FULL_TURN, 0.22f, 240, 0.08f, 1, 0, VIOLET},     // PATTERN_SPIRAL
+        {AIM_PLAYER, 7, 0.9f, 0, 300, 1.4f, 1, 0, RED},                // PATTERN_AIMED_FAN
+        {AIM_PLAYER, 3, 0.12f, 0, 420, 2.0f, 5, 0.08f, PINK},          // PATTERN_BURST
+    };
+}
+
+const EmitterPattern &GetPattern(int pattern)
+{
+    return PATTERNS[pattern];
+}
+
+Entity SpawnEmitter(EmitterArchetype &emitters, Entity owner, Scalar offsetX, Scalar offsetY, int pattern, Scalar delay)
+{
+    Emitter emitter = {owner, offsetX, offsetY, pattern, delay, 0, PATTERNS[pattern].burst};
+    return emitters.Create({0, 0}, emitter);
+}
+
+int FireVolley(const EmitterPattern &pattern, const Position &origin, Scalar directionX, Scalar directionY,
+               Scalar angle, ShotArchetype &bullets)
+{
+    // A full ring spaces bullets evenly, anything narrower is a fan from edge to edge
+    Scalar step = 0;
+    Scalar start = angle;
+    if (pattern.arc >= FULL_TURN)
+    {
+        step = pattern.arc / pattern.bullets;
+    }
+    else if (pattern.bullets > 1)
+    {
+        step = pattern.arc / (pattern.bullets - 1);
+        start -= pattern.arc / 2;
+    }
+
+    // Grow every column once, then fill them in straight loops
+    size_t first = bullets.CreateMany(pattern.bullets);
+    Position *positions = bullets.Column<Position>().data() + first;
+    Velocity *velocities = bullets.Column<Velocity>().data() + first;
+    Body *bodies = bullets.Column<Body>().data() + first;
+    Tint *tints = bullets.Column<Tint>().data() + first;
+
+    for (int i = 0; i < pattern.bullets; ++i)
+    {
+        Scalar rotation = start + step * i;
+        Scalar cosine = Cos(rotation);
+        Scalar sine = Sin(rotation);
+        velocities[i] = {(directionX * cosine - directionY * sine) * pattern.speed,
+                         (directionX * sine + directionY * cosine) * pattern.speed};
+    }
+    for (int i = 0; i < pattern.bullets; ++i)
+    {
+        positions[i] = origin;
+        bodies[i] = {BULLET_SIZE, BULLET_SIZE};
+        tints[i] = {pattern.color};
+    }
+    return pattern.bullets;
+}
+
+void EmitterSystem(EmitterArchetype &emitters, const EnemyArchetype &enemies, const PlayerArchetype &players,
+                   ShotArchetype &enemyShots, Scalar deltaTime)
+{
+    auto &positions = emitters.Column<Position>();
+    auto &states = emitters.Column<Emitter>();
+    emitters.RemoveIf([&](size_t i)
+                      { return !enemies.IsAlive(states[i].owner); });
+
+    // Aimed patterns target the first player that is still flying
+    const Position *target = nullptr;
+    for (size_t i = 0; i < players.Size(); ++i)
+    {
+        if (!players.Column<Pilot>()[i].exploding)
+        {
+            target = &players.Column<Position>()[i];
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < emitters.Size(); ++i)
+    {
+        Emitter &emitter = states[i];
+        const Position &owner = enemies.Get<Position>(emitter.owner);
+        positions[i] = {owner.x + emitter.offsetX, owner.y + emitter.offsetY};
+
+        emitter.timer -= deltaTime;
+        if (emitter.timer > 0)
+            continue;
+
+        const EmitterPattern &pattern = PATTERNS[emitter.pattern];
+        Scalar directionX = 0;
+        Scalar directionY = 1;
+        if (pattern.aim == AIM_PLAYER && target)
+        {
+            Scalar dx = target->x - positions[i].x;
+            Scalar dy = target->y - positions[i].y;
+            Scalar distance = Length(dx, dy);
+            if (distance > 0)
+            {
+                directionX = dx / distance;
+                directionY = dy / distance;
+            }
+        }
+
+        // A tick longer than the pattern's spacing owes several volleys. The movement step later this tick
+        // carries every bullet a whole deltaTime, so each volley starts that far short of where it would be
+        // by now: it ends the tick as far out as it would at a high tick rate, and the collision sweep back
+        // along deltaTime still covers its path from the muzzle.
+        for (int volleys = 0; emitter.timer <= 0 && volleys < MAX_VOLLEYS_PER_TICK; ++volleys)
+        {
+            int fired = FireVolley(pattern, positions[i], directionX, directionY, emitter.angle, enemyShots);
+            Scalar lead = -emitter.timer - deltaTime; // How long ago it was due, less the coming step
+            size_t first = enemyShots.Size() - fired;
+            Position *bullets = enemyShots.Column<Position>().data() + first;
+            const Velocity *velocities = enemyShots.Column<Velocity>().data() + first;
+            for (int bullet = 0; bullet < fired; ++bullet)
+            {
+                bullets[bullet].x += velocities[bullet].x * lead;
+                bullets[bullet].y += velocities[bullet].y * lead;
+            }
+
+            // Keep the angle small so fixed-point builds never overflow it
+            emitter.angle += pattern.spin;
+            if (emitter.angle >= FULL_TURN)
+                emitter.angle -= FULL_TURN;
+
+            // Schedule relative to when the volley was due, so the rhythm doesn't drift with the tick rate
+            if (--emitter.volleysLeft > 0)
+            {
+                emitter.timer += pattern.burstInterval;
+            }
+            else
+            {
+                emitter.volleysLeft = pattern.burst;
+                emitter.timer += pattern.interval;
+            }
+        }
+
+        // Only after a stall: let the missed volleys go rather than firing them all at once later
+        if (emitter.timer < 0)
+            emitter.timer = 0;
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef EMITTER_H
+#define EMITTER_H
+
+#include "components.h"
+
+// Bullet patterns. An emitter is mounted on an enemy and fires volleys described by an EmitterPattern;
+// rings, spirals, aimed fans and bursts are all the same volley code with different numbers.
+enum PatternId
+{
+    PATTERN_RING,
+    PATTERN_SPIRAL,
+    PATTERN_AIMED_FAN,
+    PATTERN_BURST,
+    PATTERN_COUNT
+};
+
+enum PatternAim
+{
+    AIM_DOWN,  // Volleys are centred on straight down
+    AIM_PLAYER // Volleys are centred on the player
+};
+
+struct EmitterPattern
+{
+    PatternAim aim;
+    int bullets;          // Bullets per volley
+    Scalar arc;           // Angle a volley covers in radians; a full turn spaces the bullets evenly around a ring
+    Scalar spin;          // Added to the emitter's angle after every volley, turns rings into spirals
+    Scalar speed;
+    Scalar interval;      // Time between bursts
+    int burst;            // Volleys per burst
+    Scalar burstInterval; // Time between volleys inside a burst
+    Color color;
+};
+
+const EmitterPattern &GetPattern(int pattern);
+
+Entity SpawnEmitter(EmitterArchetype &emitters, Entity owner, Scalar offsetX, Scalar offsetY, int pattern, Scalar delay);
+
+// Fires one volley centred on the unit direction (directionX, directionY), rotated by angle.
+// Bullets are appended to the archetype in bulk. Returns how many were fired.
+int FireVolley(const EmitterPattern &pattern, const Position &origin, Scalar directionX, Scalar directionY,
+               Scalar angle, ShotArchetype &bullets);
+
+// Moves emitters with their owners, drops the orphaned ones and fires whatever is due
+void EmitterSystem(EmitterArchetype &emitters, const EnemyArchetype &enemies, const PlayerArchetype &players,
+                   ShotArchetype &enemyShots, Scalar deltaTime);
+
+#endif // EMITTER_H
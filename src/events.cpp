@@ -0,0 +1,50 @@
+#include "events.h"
+#include "telemetry.h"
+
+EventQueue &EventBus::Subscribe()
+{
+    queues.emplace_back(new EventQueue());
+    return *queues.back();
+}
+
+void EventBus::Publish(const GameEventBuffer &events, uint32_t tick)
+{
+    for (auto &queue : queues)
+    {
+        for (GameEvent event : events)
+        {
+            event.tick = tick;
+            if (!queue->ring.Push(event))
+                queue->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void RecordEventTelemetry(const GameEvent &event)
+{
+    SetTelemetryTick(event.tick);
+    switch (event.type)
+    {
+    case EVENT_SHOT:
+        RecordTelemetry(TELEMETRY_SHOT, event.a, event.b);
+        break;
+    case EVENT_HIT:
+        RecordTelemetry(TELEMETRY_HIT, event.a, event.b);
+        break;
+    case EVENT_KILL:
+        RecordTelemetry(TELEMETRY_KILL, static_cast<int32_t>(event.x), static_cast<int32_t>(event.y));
+        break;
+    case EVENT_PLAYER_DEATH:
+        RecordTelemetry(TELEMETRY_DEATH, event.a);
+        break;
+    case EVENT_GAME_OVER:
+        RecordTelemetry(TELEMETRY_GAME_OVER, event.a);
+        break;
+    case EVENT_WAVE_START:
+        RecordTelemetry(TELEMETRY_WAVE, event.a, event.b);
+        break;
+    case EVENT_POWER_UP:
+        RecordTelemetry(TELEMETRY_POWER_UP, event.a);
+        break;
+    }
+}
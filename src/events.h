@@ -0,0 +1,85 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "memory.h"
+#include "spsc_ring.h"
+
+enum GameEventType
+{
+    EVENT_SHOT,         // a: weapon mode, b: projectiles fired
+    EVENT_HIT,          // a: health left on the enemy or boss part, b: 1 for a boss part
+    EVENT_KILL,
+    EVENT_PLAYER_DEATH, // a: lives left
+    EVENT_GAME_OVER,    // a: final score
+    EVENT_WAVE_START,   // a: level, b: wave
+    EVENT_POWER_UP      // a: weapon mode picked up
+};
+
+// Something that happened during a tick, for systems that react to gameplay without being part of it
+struct GameEvent
+{
+    GameEventType type;
+    uint32_t tick; // Stamped by EventBus::Publish
+    float x; // Where it happened, in virtual pixels
+    float y;
+    int32_t a;
+    int32_t b;
+};
+
+// Events raised during the current tick. Systems only append here, which keeps the hot loops free
+// of side effects; the simulation thread hands the whole batch to the EventBus once the tick is done.
+typedef TrackedVector<GameEvent, MEMORY_ENTITIES> GameEventBuffer;
+
+inline void RaiseEvent(GameEventBuffer &events, GameEventType type, float x, float y, int32_t a = 0, int32_t b = 0)
+{
+    events.push_back({type, 0, x, y, a, b});
+}
+
+// One consumer's view of the event stream, drained on the consumer's thread
+class EventQueue
+{
+public:
+    EventQueue() : dropped(0) {}
+
+    // Calls fn(event) for everything published since the last drain, oldest first
+    template <typename Fn>
+    void Drain(Fn fn)
+    {
+        GameEvent batch[64];
+        size_t count;
+        while ((count = ring.PopMany(batch, 64)) > 0)
+        {
+            for (size_t i = 0; i < count; ++i)
+                fn(batch[i]);
+        }
+    }
+
+    uint32_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    friend class EventBus;
+    SpscRing<GameEvent, 4096> ring;
+    std::atomic<uint32_t> dropped; // Events lost because the consumer fell behind
+};
+
+// Fans the simulation's events out to every subscriber through its own preallocated SPSC queue,
+// so publishing never locks or allocates. A consumer that falls behind loses events rather than
+// stalling the simulation.
+class EventBus
+{
+public:
+    EventQueue &Subscribe(); // Only before the first Publish
+    void Publish(const GameEventBuffer &events, uint32_t tick); // Only from one thread
+
+private:
+    std::vector<std::unique_ptr<EventQueue>> queues;
+};
+
+// Consumer that turns events into telemetry records stamped with the tick they happened on
+void RecordEventTelemetry(const GameEvent &event);
+
+#endif // EVENTS_H
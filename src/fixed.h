@@ -0,0 +1,193 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <cmath>
+#include <cstdint>
+
+// 16.16 signed fixed-point number. All arithmetic is integer, so results are bit-identical
+// across compilers, optimisation levels and CPUs.
+class Fixed
+{
+public:
+    static const int FRACTION_BITS = 16;
+    static const int32_t ONE = 1 << FRACTION_BITS;
+
+    constexpr Fixed() : raw(0) {}
+    constexpr Fixed(int value) : raw(value * ONE) {}
+    constexpr Fixed(float value) : raw(static_cast<int32_t>(value * ONE + (value >= 0 ? 0.5f : -0.5f))) {}
+    constexpr Fixed(double value) : raw(static_cast<int32_t>(value * ONE + (value >= 0 ? 0.5 : -0.5))) {}
+
+    static constexpr Fixed FromRaw(int32_t raw)
+    {
+        Fixed result;
+        result.raw = raw;
+        return result;
+    }
+
+    constexpr int32_t Raw() const { return raw; }
+    constexpr float ToFloat() const { return static_cast<float>(raw) / ONE; }
+    constexpr int ToInt() const { return raw >> FRACTION_BITS; } // Rounds towards negative infinity
+
+    constexpr Fixed operator-() const { return FromRaw(-raw); }
+    Fixed &operator+=(Fixed other) { raw += other.raw; return *this; }
+    Fixed &operator-=(Fixed other) { raw -= other.raw; return *this; }
+    Fixed &operator*=(Fixed other) { raw = Multiply(raw, other.raw); return *this; }
+    Fixed &operator/=(Fixed other) { raw = Divide(raw, other.raw); return *this; }
+
+    friend constexpr Fixed operator+(Fixed a, Fixed b) { return FromRaw(a.raw + b.raw); }
+    friend constexpr Fixed operator-(Fixed a, Fixed b) { return FromRaw(a.raw - b.raw); }
+    friend constexpr Fixed operator*(Fixed a, Fixed b) { return FromRaw(Multiply(a.raw, b.raw)); }
+    friend constexpr Fixed operator/(Fixed a, Fixed b) { return FromRaw(Divide(a.raw, b.raw)); }
+    friend constexpr bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+    friend constexpr bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+    friend constexpr bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+    friend constexpr bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+    friend constexpr bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+    friend constexpr bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+private:
+    int32_t raw;
+
+    static constexpr int32_t Multiply(int32_t a, int32_t b)
+    {
+        return static_cast<int32_t>((static_cast<int64_t>(a) * b) >> FRACTION_BITS);
+    }
+
+    static constexpr int32_t Divide(int32_t a, int32_t b)
+    {
+        return static_cast<int32_t>((static_cast<int64_t>(a) * ONE) / b);
+    }
+};
+
+namespace trig
+{
+    const int TABLE_BITS = 10;
+    const int TABLE_SIZE = 1 << TABLE_BITS; // Entries per full turn
+    const double TWO_PI = 6.283185307179586476925;
+
+    struct SineTable
+    {
+        int32_t fixed[TABLE_SIZE + 1]; // One extra entry so interpolation never wraps
+        float floats[TABLE_SIZE + 1];
+    };
+
+    // Taylor series, good to double precision for |x| <= pi
+    constexpr double Sine(double x)
+    {
+        double term = x;
+        double sum = x;
+        for (int k = 1; k < 24; ++k)
+        {
+            term *= -x * x / ((2 * k) * (2 * k + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr SineTable MakeSineTable()
+    {
+        SineTable table{};
+        for (int i = 0; i <= TABLE_SIZE; ++i)
+        {
+            double angle = TWO_PI * i / TABLE_SIZE;
+            if (angle > TWO_PI / 2)
+                angle -= TWO_PI;
+            double value = Sine(angle);
+            table.fixed[i] = static_cast<int32_t>(value * Fixed::ONE + (value >= 0 ? 0.5 : -0.5));
+            table.floats[i] = static_cast<float>(value);
+        }
+        return table;
+    }
+
+    constexpr SineTable SINE_TABLE = MakeSineTable();
+
+    // Radians to table index, as a 16.16 value
+    const int64_t RADIANS_TO_INDEX = static_cast<int64_t>(TABLE_SIZE / TWO_PI * Fixed::ONE + 0.5);
+}
+
+// Table lookups with linear interpolation. The fixed-point versions are pure integer math.
+inline Fixed Sin(Fixed radians)
+{
+    int64_t phase = (static_cast<int64_t>(radians.Raw()) * trig::RADIANS_TO_INDEX) >> Fixed::FRACTION_BITS;
+    int index = static_cast<int>((phase >> Fixed::FRACTION_BITS) & (trig::TABLE_SIZE - 1));
+    int32_t fraction = static_cast<int32_t>(phase & (Fixed::ONE - 1));
+    int32_t a = trig::SINE_TABLE.fixed[index];
+    int32_t b = trig::SINE_TABLE.fixed[index + 1];
+    return Fixed::FromRaw(a + static_cast<int32_t>((static_cast<int64_t>(b - a) * fraction) >> Fixed::FRACTION_BITS));
+}
+
+inline Fixed Cos(Fixed radians)
+{
+    return Sin(radians + Fixed::FromRaw(102944)); // pi / 2
+}
+
+inline float Sin(float radians)
+{
+    float phase = radians * static_cast<float>(trig::TABLE_SIZE / trig::TWO_PI);
+    float whole = static_cast<float>(static_cast<int64_t>(phase) - (phase < 0 ? 1 : 0));
+    int index = static_cast<int>(static_cast<int64_t>(whole) & (trig::TABLE_SIZE - 1));
+    float fraction = phase - whole;
+    float a = trig::SINE_TABLE.floats[index];
+    return a + (trig::SINE_TABLE.floats[index + 1] - a) * fraction;
+}
+
+inline float Cos(float radians)
+{
+    return Sin(radians + 1.5707963267948966f);
+}
+
+inline float ToFloat(Fixed value) { return value.ToFloat(); }
+inline float ToFloat(float value) { return value; }
+
+// Squared vector length that can't overflow: raw 32.32 units for Fixed, plain float otherwise
+inline int64_t LengthSquared(Fixed x, Fixed y)
+{
+    return static_cast<int64_t>(x.Raw()) * x.Raw() + static_cast<int64_t>(y.Raw()) * y.Raw();
+}
+
+inline float LengthSquared(float x, float y) { return x * x + y * y; }
+
+// Integer square root, exact and platform independent
+inline uint64_t ISqrt(uint64_t value)
+{
+    uint64_t result = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > value)
+        bit >>= 2;
+    while (bit != 0)
+    {
+        if (value >= result + bit)
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+inline Fixed Length(Fixed x, Fixed y) { return Fixed::FromRaw(static_cast<int32_t>(ISqrt(LengthSquared(x, y)))); }
+inline float Length(float x, float y) { return sqrtf(LengthSquared(x, y)); }
+
+// Numeric type used by the simulation. Build with FIXED_POINT=TRUE (GALAGA_FIXED_POINT)
+// for bit-reproducible simulation across builds, e.g. for replays and lockstep sessions.
+#ifdef GALAGA_FIXED_POINT
+typedef Fixed Scalar;
+#else
+typedef float Scalar;
+#endif
+
+template <typename T>
+inline T Min(T a, T b) { return b < a ? b : a; }
+
+template <typename T>
+inline T Max(T a, T b) { return a < b ? b : a; }
+
+template <typename T>
+inline T Clamp(T value, T low, T high) { return Max(low, Min(value, high)); }
+
+#endif // FIXED_H
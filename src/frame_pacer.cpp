@@ -0,0 +1,102 @@
+#include "frame_pacer.h"
+#include "telemetry.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+namespace
+{
+    const double MIN_SPIN_NS = 100e3; // Even a punctual sleep gets this much spin
+    const double MAX_SPIN_NS = 4e6;
+    const long long ABSOLUTE_BUCKET_NS = 20000;
+}
+
+FramePacer::FramePacer(double rate)
+    : rate(0), period(0), spinMargin(1000000), oversleep(450e3), started(false), histogram(), absolute(), count(0), worst(0)
+{
+    SetRate(rate);
+}
+
+void FramePacer::SetRate(double rate)
+{
+    this->rate = std::max(0.0, rate);
+    period = std::chrono::nanoseconds(this->rate > 0 ? static_cast<long long>(1e9 / this->rate) : 0);
+    started = false; // The next frame starts a new schedule
+}
+
+void FramePacer::Wait()
+{
+    Clock::time_point now = Clock::now();
+    if (period.count() > 0 && started)
+    {
+        if (now - deadline > period)
+        {
+            deadline = now; // More than a frame late: start over rather than rush to catch up
+        }
+        else
+        {
+            // Sleep through most of the wait, then spin the tail the scheduler would miss
+            Clock::time_point wake = deadline - spinMargin;
+            if (now < wake)
+            {
+                std::this_thread::sleep_until(wake);
+                double late = std::chrono::duration<double, std::nano>(Clock::now() - wake).count();
+                oversleep += (late - oversleep) / 16;
+                spinMargin = std::chrono::nanoseconds(static_cast<long long>(std::min(oversleep * 2 + MIN_SPIN_NS, MAX_SPIN_NS)));
+            }
+            while (Clock::now() < deadline)
+            {
+            }
+        }
+        now = Clock::now();
+    }
+    else
+    {
+        deadline = now;
+    }
+
+    if (started)
+        Record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastPresent));
+    lastPresent = now;
+    started = true;
+    deadline += period;
+}
+
+void FramePacer::Record(std::chrono::nanoseconds interval)
+{
+    long long difference = (interval - period).count();
+    RecordTelemetry(TELEMETRY_PACING, static_cast<int32_t>(interval.count() / 1000), static_cast<int32_t>(difference / 1000));
+    if (period.count() == 0)
+        return; // No target to be off from
+
+    const long long bucketNs = JITTER_BUCKET_US * 1000LL;
+    long long bucket = (difference + (difference < 0 ? -bucketNs / 2 : bucketNs / 2)) / bucketNs + JITTER_BUCKETS / 2;
+    histogram[std::max(0LL, std::min<long long>(bucket, JITTER_BUCKETS - 1))]++;
+    long long magnitude = std::llabs(difference);
+    const long long absoluteBuckets = sizeof(absolute) / sizeof(absolute[0]);
+    absolute[std::min(magnitude / ABSOLUTE_BUCKET_NS, absoluteBuckets - 1)]++;
+    worst = std::max(worst, magnitude);
+    count++;
+}
+
+double FramePacer::JitterPercentileMs(double percentile) const
+{
+    size_t target = static_cast<size_t>(count * percentile / 100);
+    size_t seen = 0;
+    for (size_t bucket = 0; bucket < sizeof(absolute) / sizeof(absolute[0]); ++bucket)
+    {
+        seen += absolute[bucket];
+        if (seen > target)
+            return std::min((bucket + 1) * ABSOLUTE_BUCKET_NS / 1e6, WorstJitterMs()); // Upper edge of the bucket
+    }
+    return WorstJitterMs();
+}
+
+void FramePacer::Print() const
+{
+    if (count == 0)
+        return;
+    printf("Frame pacing at %.0f Hz: %zu frames, jitter p50 %.2f ms, p99 %.2f ms, max %.2f ms, spin tail %.2f ms\n", rate,
+           count, JitterPercentileMs(50), JitterPercentileMs(99), WorstJitterMs(), SpinMs());
+}
@@ -0,0 +1,49 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <cstddef>
+
+// Holds each frame until its slot on a fixed-rate schedule. The bulk of the wait is an OS sleep; the last
+// stretch, which the scheduler can't hit reliably, is a spin on the high-resolution clock. The spin tail
+// tracks how late sleeps actually wake, so it stays short on a quiet machine. Each present-to-present
+// interval is compared with the target period and counted in a jitter histogram.
+class FramePacer
+{
+public:
+    // Interval minus period in JITTER_BUCKET_US steps, the middle bucket centred on 0; the outermost buckets
+    // also collect everything beyond them
+    static const int JITTER_BUCKETS = 41;
+    static const int JITTER_BUCKET_US = 250;
+
+    explicit FramePacer(double rate);
+    void SetRate(double rate); // Frames per second; 0 doesn't wait
+    double Rate() const { return rate; }
+    void Wait(); // Right before presenting
+
+    unsigned long Bucket(int bucket) const { return histogram[bucket]; }
+    size_t Count() const { return count; }
+    double JitterPercentileMs(double percentile) const; // Of the absolute difference from the period
+    double WorstJitterMs() const { return worst / 1e6; }
+    double SpinMs() const { return spinMargin.count() / 1e6; }
+    void Print() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    double rate;
+    std::chrono::nanoseconds period;
+    std::chrono::nanoseconds spinMargin; // Woken this long before the deadline
+    double oversleep;                    // Moving average of how late sleeps wake, in nanoseconds
+    Clock::time_point deadline;          // When the next frame should be presented
+    Clock::time_point lastPresent;
+    bool started;
+    unsigned long histogram[JITTER_BUCKETS];
+    unsigned long absolute[1000]; // Absolute differences in 20 us steps, for percentiles
+    size_t count;
+    long long worst; // Largest absolute difference, in nanoseconds
+
+    void Record(std::chrono::nanoseconds interval);
+};
+
+#endif // FRAME_PACER_H
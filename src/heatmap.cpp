@@ -0,0 +1,111 @@
+#include "heatmap.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    const char *LAYER_NAMES[HEAT_LAYER_COUNT] = {"player", "deaths", "kills"};
+    const int IMAGE_SCALE = 8; // Image pixels per cell side
+}
+
+Heatmap::Heatmap()
+{
+    Clear();
+}
+
+void Heatmap::Clear()
+{
+    memset(cells, 0, sizeof(cells));
+}
+
+void Heatmap::Add(HeatmapLayer layer, float x, float y)
+{
+    if (!(x >= 0 && y >= 0)) // Also rejects NaN
+        return;
+    int column = static_cast<int>(x) / CELL_SIZE;
+    int row = static_cast<int>(y) / CELL_SIZE;
+    if (column < COLUMNS && row < ROWS)
+        cells[layer][row][column]++;
+}
+
+void Heatmap::AddEvents(const GameEventBuffer &events)
+{
+    for (const GameEvent &event : events)
+    {
+        if (event.type == EVENT_PLAYER_DEATH)
+            Add(HEAT_DEATH, event.x, event.y);
+        else if (event.type == EVENT_KILL)
+            Add(HEAT_KILL, event.x, event.y);
+    }
+}
+
+void Heatmap::Merge(const Heatmap &other)
+{
+    for (int layer = 0; layer < HEAT_LAYER_COUNT; ++layer)
+    {
+        for (int row = 0; row < ROWS; ++row)
+        {
+            for (int column = 0; column < COLUMNS; ++column)
+            {
+                cells[layer][row][column] += other.cells[layer][row][column];
+            }
+        }
+    }
+}
+
+bool Heatmap::Export(const std::string &prefix) const
+{
+    FILE *csv = fopen((prefix + ".csv").c_str(), "w");
+    if (!csv)
+        return false;
+    fprintf(csv, "x,y");
+    for (const char *name : LAYER_NAMES)
+    {
+        fprintf(csv, ",%s", name);
+    }
+    fprintf(csv, "\n");
+    for (int row = 0; row < ROWS; ++row)
+    {
+        for (int column = 0; column < COLUMNS; ++column)
+        {
+            // Cell centres in virtual pixels
+            fprintf(csv, "%d,%d", column * CELL_SIZE + CELL_SIZE / 2, row * CELL_SIZE + CELL_SIZE / 2);
+            for (int layer = 0; layer < HEAT_LAYER_COUNT; ++layer)
+            {
+                fprintf(csv, ",%u", cells[layer][row][column]);
+            }
+            fprintf(csv, "\n");
+        }
+    }
+    bool written = fclose(csv) == 0;
+
+    for (int layer = 0; layer < HEAT_LAYER_COUNT && written; ++layer)
+    {
+        FILE *image = fopen((prefix + "-" + LAYER_NAMES[layer] + ".pgm").c_str(), "wb");
+        if (!image)
+            return false;
+        uint32_t most = 0;
+        for (int row = 0; row < ROWS; ++row)
+        {
+            most = std::max(most, *std::max_element(cells[layer][row], cells[layer][row] + COLUMNS));
+        }
+        fprintf(image, "P5\n%d %d\n255\n", COLUMNS * IMAGE_SCALE, ROWS * IMAGE_SCALE);
+        unsigned char line[COLUMNS * IMAGE_SCALE];
+        for (int row = 0; row < ROWS; ++row)
+        {
+            for (int column = 0; column < COLUMNS; ++column)
+            {
+                double level = most > 0 ? std::log1p(cells[layer][row][column]) / std::log1p(most) : 0;
+                memset(line + column * IMAGE_SCALE, static_cast<int>(level * 255 + 0.5), IMAGE_SCALE);
+            }
+            for (int repeat = 0; repeat < IMAGE_SCALE; ++repeat)
+            {
+                fwrite(line, 1, sizeof(line), image);
+            }
+        }
+        written = fclose(image) == 0;
+    }
+    return written;
+}
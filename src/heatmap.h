@@ -0,0 +1,40 @@
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+#include <cstdint>
+#include <string>
+#include "events.h"
+
+enum HeatmapLayer
+{
+    HEAT_PLAYER, // Ticks the player spent in the cell
+    HEAT_DEATH,  // Lives lost there
+    HEAT_KILL,   // Enemies destroyed there
+    HEAT_LAYER_COUNT
+};
+
+// Coarse density grids over the 1920x1080 virtual field. The counts live in the object itself, so
+// recording never allocates and costs a few increments per tick; grids from separate runs add up with Merge.
+class Heatmap
+{
+public:
+    static const int CELL_SIZE = 30; // Virtual pixels per side
+    static const int COLUMNS = 64;
+    static const int ROWS = 36;
+
+    Heatmap();
+    void Clear();
+    void Add(HeatmapLayer layer, float x, float y); // Positions off the field are ignored
+    void AddEvents(const GameEventBuffer &events);  // Deaths and kills
+    void Merge(const Heatmap &other);
+    uint32_t Count(HeatmapLayer layer, int column, int row) const { return cells[layer][row][column]; }
+
+    // PREFIX.csv with a row per cell and a column per layer, plus a PREFIX-LAYER.pgm greyscale image per
+    // layer, log scaled so sparse cells still show
+    bool Export(const std::string &prefix) const;
+
+private:
+    uint32_t cells[HEAT_LAYER_COUNT][ROWS][COLUMNS];
+};
+
+#endif // HEATMAP_H
@@ -0,0 +1,41 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <chrono>
+#include <cstdint>
+
+// Controls sampled on the render thread and consumed by the simulation
+struct PlayerInput
+{
+    bool left;
+    bool right;
+    bool up;
+    bool down;
+    bool fire; // Fire was pressed since the last tick
+};
+
+// Button bits of an InputSample
+enum InputButton
+{
+    INPUT_LEFT = 1 << 0,
+    INPUT_RIGHT = 1 << 1,
+    INPUT_UP = 1 << 2,
+    INPUT_DOWN = 1 << 3,
+    INPUT_FIRE = 1 << 4
+};
+
+// One timestamped reading of the controls, taken by the render thread or the input sampler
+struct InputSample
+{
+    unsigned held;    // InputButton bits down when the sample was taken
+    bool firePressed; // Fire went down since the previous sample, even if it was released again
+    int64_t time;     // InputClockNow() at the moment the input happened
+};
+
+// Steady clock in nanoseconds, the time base of input samples and latency measurements
+inline int64_t InputClockNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // INPUT_H
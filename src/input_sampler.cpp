@@ -0,0 +1,295 @@
+#include "input_sampler.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstdio>
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+// <windows.h> can't share a translation unit with raylib (Rectangle, CloseWindow, DrawText and more clash),
+// so the one user32 entry point the sampler needs is declared here
+extern "C" __declspec(dllimport) short __stdcall GetAsyncKeyState(int virtualKey);
+#endif
+
+namespace
+{
+    const std::chrono::microseconds SAMPLE_INTERVAL(1000);
+    const int64_t LATENCY_BUCKET = 100000; // Nanoseconds per histogram bucket
+    const size_t LATENCY_BUCKETS = 2000;   // Covers 200 ms
+
+#ifdef __linux__
+    const int MAX_DEVICES = 32;
+
+    struct KeyBinding
+    {
+        int code;
+        unsigned button;
+    };
+
+    const KeyBinding BINDINGS[] = {
+        {KEY_A, INPUT_LEFT}, {KEY_LEFT, INPUT_LEFT},
+        {KEY_D, INPUT_RIGHT}, {KEY_RIGHT, INPUT_RIGHT},
+        {KEY_W, INPUT_UP}, {KEY_UP, INPUT_UP},
+        {KEY_S, INPUT_DOWN}, {KEY_DOWN, INPUT_DOWN},
+        {KEY_SPACE, INPUT_FIRE}, {BTN_LEFT, INPUT_FIRE},
+    };
+
+    bool HasBit(const unsigned char *bits, int bit)
+    {
+        return (bits[bit / 8] >> (bit % 8)) & 1;
+    }
+#elif defined(_WIN32)
+    // Virtual key codes from winuser.h; letters are their ASCII capitals
+    const int VK_LBUTTON = 0x01;
+    const int VK_SPACE = 0x20;
+    const int VK_LEFT = 0x25;
+    const int VK_UP = 0x26;
+    const int VK_RIGHT = 0x27;
+    const int VK_DOWN = 0x28;
+
+    struct KeyBinding
+    {
+        int virtualKey;
+        unsigned button;
+    };
+
+    const KeyBinding BINDINGS[] = {
+        {'A', INPUT_LEFT}, {VK_LEFT, INPUT_LEFT},
+        {'D', INPUT_RIGHT}, {VK_RIGHT, INPUT_RIGHT},
+        {'W', INPUT_UP}, {VK_UP, INPUT_UP},
+        {'S', INPUT_DOWN}, {VK_DOWN, INPUT_DOWN},
+        {VK_SPACE, INPUT_FIRE}, {VK_LBUTTON, INPUT_FIRE},
+    };
+#endif
+}
+
+InputSampler::InputSampler(SimulationThread &simulation)
+    : simulation(simulation), quit(false), focused(true)
+{
+}
+
+InputSampler::~InputSampler()
+{
+    Stop();
+}
+
+bool InputSampler::Start()
+{
+    if (!OpenDevices())
+    {
+        LOG_INFO("raw input unavailable, sampling input once per frame");
+        return false;
+    }
+    quit = false;
+    thread = std::thread(&InputSampler::Run, this);
+    return true;
+}
+
+void InputSampler::Stop()
+{
+    if (thread.joinable())
+    {
+        quit = true;
+        thread.join();
+    }
+    CloseDevices();
+}
+
+bool InputSampler::Running() const
+{
+    return thread.joinable();
+}
+
+void InputSampler::SetFocused(bool focused)
+{
+    this->focused.store(focused, std::memory_order_relaxed);
+}
+
+void InputSampler::Run()
+{
+    std::chrono::steady_clock::time_point nextSample = std::chrono::steady_clock::now();
+    while (!quit)
+    {
+        // The simulation only queues samples that change something, so submitting every one is cheap
+        InputSample sample;
+        Sample(sample);
+        simulation.SubmitInput(sample);
+
+        nextSample += SAMPLE_INTERVAL;
+        std::this_thread::sleep_until(nextSample);
+    }
+}
+
+#ifdef __linux__
+bool InputSampler::OpenDevices()
+{
+    keysDown.assign(KEY_CNT, false);
+    for (int index = 0; index < MAX_DEVICES; ++index)
+    {
+        char path[32];
+        snprintf(path, sizeof(path), "/dev/input/event%d", index);
+        int device = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (device < 0)
+            continue;
+
+        // Only keep devices that report a key or button we listen to
+        unsigned char keyBits[KEY_CNT / 8 + 1] = {};
+        bool wanted = false;
+        if (ioctl(device, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) >= 0)
+        {
+            for (const KeyBinding &binding : BINDINGS)
+            {
+                wanted = wanted || HasBit(keyBits, binding.code);
+            }
+        }
+        // Event timestamps on the monotonic clock, which is what steady_clock reads
+        int clock = CLOCK_MONOTONIC;
+        if (!wanted || ioctl(device, EVIOCSCLOCKID, &clock) < 0)
+        {
+            close(device);
+            continue;
+        }
+        devices.push_back(device);
+    }
+    return !devices.empty();
+}
+
+void InputSampler::CloseDevices()
+{
+    for (int device : devices)
+    {
+        close(device);
+    }
+    devices.clear();
+}
+
+void InputSampler::Sample(InputSample &sample)
+{
+    sample.firePressed = false;
+    sample.time = 0;
+
+    input_event events[64];
+    for (int device : devices)
+    {
+        ssize_t bytes;
+        while ((bytes = read(device, events, sizeof(events))) > 0)
+        {
+            for (size_t i = 0; i < bytes / sizeof(input_event); ++i)
+            {
+                const input_event &event = events[i];
+                if (event.type != EV_KEY || event.code >= KEY_CNT || event.value == 2)
+                    continue; // Ignore autorepeat
+
+                bool down = event.value != 0;
+                if (keysDown[event.code] == down)
+                    continue;
+                keysDown[event.code] = down;
+
+                int64_t time = static_cast<int64_t>(event.time.tv_sec) * 1000000000 + event.time.tv_usec * 1000;
+                if (sample.time == 0)
+                    sample.time = time;
+                for (const KeyBinding &binding : BINDINGS)
+                {
+                    if (down && binding.code == event.code && binding.button == INPUT_FIRE)
+                        sample.firePressed = true;
+                }
+            }
+        }
+    }
+
+    sample.held = 0;
+    for (const KeyBinding &binding : BINDINGS)
+    {
+        if (keysDown[binding.code])
+            sample.held |= binding.button;
+    }
+
+    // evdev sees every keyboard, so ignore it while another window has focus
+    if (!focused.load(std::memory_order_relaxed))
+    {
+        sample.held = 0;
+        sample.firePressed = false;
+    }
+    if (sample.time == 0)
+        sample.time = InputClockNow();
+}
+#elif defined(_WIN32)
+bool InputSampler::OpenDevices()
+{
+    keysDown.assign(256, false);
+    return true;
+}
+
+void InputSampler::CloseDevices()
+{
+}
+
+void InputSampler::Sample(InputSample &sample)
+{
+    sample.held = 0;
+    sample.firePressed = false;
+    sample.time = InputClockNow();
+    bool active = focused.load(std::memory_order_relaxed);
+    for (const KeyBinding &binding : BINDINGS)
+    {
+        bool down = active && (GetAsyncKeyState(binding.virtualKey) & 0x8000) != 0;
+        if (down)
+            sample.held |= binding.button;
+        if (down && !keysDown[binding.virtualKey] && binding.button == INPUT_FIRE)
+            sample.firePressed = true;
+        keysDown[binding.virtualKey] = down;
+    }
+}
+#else
+bool InputSampler::OpenDevices()
+{
+    return false;
+}
+
+void InputSampler::CloseDevices()
+{
+}
+
+void InputSampler::Sample(InputSample &)
+{
+}
+#endif
+
+LatencyStats::LatencyStats()
+    : buckets(LATENCY_BUCKETS, 0), count(0), total(0), last(0), worst(0)
+{
+}
+
+void LatencyStats::Add(int64_t nanoseconds)
+{
+    size_t bucket = static_cast<size_t>(std::max<int64_t>(0, nanoseconds) / LATENCY_BUCKET);
+    buckets[std::min(bucket, LATENCY_BUCKETS - 1)]++;
+    count++;
+    total += nanoseconds;
+    last = nanoseconds;
+    worst = std::max(worst, nanoseconds);
+}
+
+double LatencyStats::PercentileMs(double percentile) const
+{
+    size_t target = static_cast<size_t>(count * percentile / 100);
+    size_t seen = 0;
+    for (size_t bucket = 0; bucket < buckets.size(); ++bucket)
+    {
+        seen += buckets[bucket];
+        if (seen > target)
+            return std::min((bucket + 1) * LATENCY_BUCKET / 1e6, MaxMs()); // Upper edge of the bucket
+    }
+    return MaxMs();
+}
+
+void LatencyStats::Print(const char *name) const
+{
+    if (count == 0)
+        return;
+    printf("%s: %zu samples, avg %.2f ms, p50 %.1f ms, p99 %.1f ms, max %.2f ms\n", name, count, AverageMs(),
+           PercentileMs(50), PercentileMs(99), MaxMs());
+}
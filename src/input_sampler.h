@@ -0,0 +1,58 @@
+#ifndef INPUT_SAMPLER_H
+#define INPUT_SAMPLER_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "simulation.h"
+
+// Reads the keyboard and mouse on its own thread at about 1 kHz and feeds timestamped samples to the
+// simulation, so presses between or shorter than frames keep their timing. Uses evdev on Linux (needs read
+// access to /dev/input) and GetAsyncKeyState on Windows; where neither works, Start fails and the
+// render thread keeps sampling once per frame.
+class InputSampler
+{
+public:
+    explicit InputSampler(SimulationThread &simulation);
+    ~InputSampler();
+    bool Start();
+    void Stop();
+    bool Running() const;
+    void SetFocused(bool focused); // Input only reaches the game while its window has focus
+
+private:
+    SimulationThread &simulation;
+    std::thread thread;
+    std::atomic<bool> quit;
+    std::atomic<bool> focused;
+    std::vector<int> devices; // Open evdev descriptors
+    std::vector<bool> keysDown; // Indexed by evdev key code
+
+    void Run();
+    bool OpenDevices();
+    void CloseDevices();
+    void Sample(InputSample &sample);
+};
+
+// Input-to-present latency, collected into a histogram so percentiles are cheap
+class LatencyStats
+{
+public:
+    LatencyStats();
+    void Add(int64_t nanoseconds);
+    size_t Count() const { return count; }
+    double LastMs() const { return last / 1e6; }
+    double AverageMs() const { return count ? total / count / 1e6 : 0; }
+    double MaxMs() const { return worst / 1e6; }
+    double PercentileMs(double percentile) const;
+    void Print(const char *name) const;
+
+private:
+    std::vector<unsigned> buckets; // 0.1 ms each, the last one collects everything slower
+    size_t count;
+    double total;
+    int64_t last;
+    int64_t worst;
+};
+
+#endif // INPUT_SAMPLER_H
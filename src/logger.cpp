@@ -0,0 +1,243 @@
+#include "logger.h"
+#include "memory.h"
+#include "spsc_ring.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const size_t RING_CAPACITY = 512; // Records per thread between flushes
+    const int MAX_FIELDS = 6;         // Further fields are left off
+    const size_t TEXT_SIZE = 96;      // Room for copied text values; longer ones are cut short
+    const std::chrono::milliseconds FLUSH_INTERVAL(20);
+
+    const char *LEVEL_NAMES[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+
+    struct RecordField
+    {
+        const char *key;
+        LogField::Type type;
+        union
+        {
+            int64_t integer;
+            double real;
+            uint32_t textOffset; // Into LogRecord::text
+        };
+    };
+
+    struct LogRecord
+    {
+        uint64_t time; // Nanoseconds since the program started
+        const char *message;
+        uint8_t level;
+        uint8_t fieldCount;
+        uint16_t thread;
+        RecordField fields[MAX_FIELDS];
+        char text[TEXT_SIZE];
+    };
+
+    struct ThreadRing
+    {
+        SpscRing<LogRecord, RING_CAPACITY> ring;
+        std::atomic<uint32_t> dropped; // Records lost since the sink last reported
+        uint16_t id;
+    };
+
+    // Rings are never freed, so a thread's cached pointer stays valid after StopLog
+    std::mutex ringsMutex;
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    thread_local ThreadRing *threadRing = nullptr;
+
+    const Clock::time_point programStart = Clock::now();
+    std::atomic<int> minimumLevel(LOG_LEVEL_DEBUG);
+    std::thread sink;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::atomic<bool> stopped(false); // Set once StopLog has drained the rings; records then bypass them
+    std::mutex directMutex;           // Keeps records written straight away from interleaving
+
+    ThreadRing &GetThreadRing()
+    {
+        if (!threadRing)
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            rings.emplace_back(new ThreadRing());
+            TrackAllocation(MEMORY_TELEMETRY, sizeof(ThreadRing)); // Lives as long as the process
+            threadRing = rings.back().get();
+            threadRing->dropped = 0;
+            threadRing->id = static_cast<uint16_t>(rings.size() - 1);
+        }
+        return *threadRing;
+    }
+
+    void WriteText(FILE *out, const char *text)
+    {
+        // Quoted when it would otherwise read as several fields
+        if (*text && !strpbrk(text, " =\""))
+            fputs(text, out);
+        else
+            fprintf(out, "\"%s\"", text);
+    }
+
+    void WriteRecord(const LogRecord &record)
+    {
+        FILE *out = record.level >= LOG_LEVEL_WARNING ? stderr : stdout;
+        fprintf(out, "[%10.3f] %-5s %s", record.time / 1e9, LEVEL_NAMES[record.level], record.message);
+        for (int i = 0; i < record.fieldCount; ++i)
+        {
+            const RecordField &field = record.fields[i];
+            fprintf(out, " %s=", field.key);
+            if (field.type == LogField::INTEGER)
+                fprintf(out, "%lld", static_cast<long long>(field.integer));
+            else if (field.type == LogField::REAL)
+                fprintf(out, "%g", field.real);
+            else
+                WriteText(out, record.text + field.textOffset);
+        }
+        fputc('\n', out);
+    }
+
+    // Sink thread only. Rings are drained one after another, so the batch is put back in time order.
+    void Flush(TrackedVector<LogRecord, MEMORY_TELEMETRY> &batch, TrackedVector<LogRecord, MEMORY_TELEMETRY> &scratch)
+    {
+        batch.clear();
+        uint32_t dropped = 0;
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            for (auto &entry : rings)
+            {
+                size_t count;
+                while ((count = entry->ring.PopMany(scratch.data(), scratch.size())) > 0)
+                {
+                    batch.insert(batch.end(), scratch.begin(), scratch.begin() + count);
+                }
+                dropped += entry->dropped.exchange(0);
+            }
+        }
+        if (batch.empty() && dropped == 0)
+            return;
+
+        std::stable_sort(batch.begin(), batch.end(), [](const LogRecord &a, const LogRecord &b)
+                         { return a.time < b.time; });
+        for (const LogRecord &record : batch)
+        {
+            WriteRecord(record);
+        }
+        if (dropped > 0)
+            fprintf(stderr, "%u log records dropped, rings were full\n", dropped);
+        fflush(stdout);
+        fflush(stderr);
+    }
+
+    void SinkLoop()
+    {
+        TrackedVector<LogRecord, MEMORY_TELEMETRY> batch;
+        TrackedVector<LogRecord, MEMORY_TELEMETRY> scratch(RING_CAPACITY);
+        bool done = false;
+        while (!done)
+        {
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wake.wait_for(lock, FLUSH_INTERVAL, []
+                              { return stopping; });
+                done = stopping;
+            }
+            Flush(batch, scratch);
+        }
+    }
+}
+
+void StartLog()
+{
+    if (sink.joinable())
+        return;
+
+    stopping = false;
+    stopped.store(false);
+    sink = std::thread(SinkLoop);
+}
+
+void StopLog()
+{
+    if (!sink.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    sink.join();
+    stopped.store(true);
+}
+
+void SetLogLevel(LogLevel level)
+{
+    minimumLevel.store(level, std::memory_order_relaxed);
+}
+
+void WriteLog(LogLevel level, const char *message, std::initializer_list<LogField> fields)
+{
+    if (level < minimumLevel.load(std::memory_order_relaxed))
+        return;
+
+    LogRecord record;
+    record.time = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - programStart).count();
+    record.message = message;
+    record.level = static_cast<uint8_t>(level);
+    record.fieldCount = 0;
+    size_t textUsed = 0;
+    for (const LogField &field : fields)
+    {
+        if (record.fieldCount == MAX_FIELDS)
+            break;
+        RecordField &out = record.fields[record.fieldCount++];
+        out.key = field.key;
+        out.type = field.type;
+        if (field.type == LogField::INTEGER)
+        {
+            out.integer = field.integer;
+        }
+        else if (field.type == LogField::REAL)
+        {
+            out.real = field.real;
+        }
+        else
+        {
+            // Copied, cut short to whatever room is left; the last byte always ends a string
+            const char *text = field.text ? field.text : "(null)";
+            size_t length = std::min(strlen(text), TEXT_SIZE - 1 - textUsed);
+            out.textOffset = static_cast<uint32_t>(textUsed);
+            memcpy(record.text + textUsed, text, length);
+            record.text[textUsed + length] = '\0';
+            textUsed = std::min(textUsed + length + 1, TEXT_SIZE - 1);
+        }
+    }
+
+    // Nothing drains the rings any more, so shutdown reports are written on the caller's thread
+    if (stopped.load())
+    {
+        std::lock_guard<std::mutex> lock(directMutex);
+        WriteRecord(record);
+        fflush(record.level >= LOG_LEVEL_WARNING ? stderr : stdout);
+        return;
+    }
+
+    ThreadRing &ring = GetThreadRing();
+    record.thread = ring.id;
+    if (!ring.ring.Push(record))
+    {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed); // Never block the caller on the sink
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+// Structured logging that never blocks the caller. A log call copies its message pointer, fields and a
+// timestamp into a binary record on the calling thread's lock-free ring; a sink thread formats the
+// records and writes them out. Messages and field keys must be string literals; text values are copied.
+
+enum LogLevel
+{
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARNING,
+    LOG_LEVEL_ERROR
+};
+
+// Log calls below this level compile to nothing; build with -DGALAGA_LOG_LEVEL=0 for debug output
+#ifndef GALAGA_LOG_LEVEL
+#define GALAGA_LOG_LEVEL 1
+#endif
+
+// One key=value pair of a record
+struct LogField
+{
+    enum Type : uint8_t
+    {
+        INTEGER,
+        REAL,
+        TEXT
+    };
+
+    LogField(const char *key, int value) : key(key), type(INTEGER), integer(value) {}
+    LogField(const char *key, unsigned value) : key(key), type(INTEGER), integer(value) {}
+    LogField(const char *key, long value) : key(key), type(INTEGER), integer(value) {}
+    LogField(const char *key, unsigned long value) : key(key), type(INTEGER), integer(static_cast<int64_t>(value)) {}
+    LogField(const char *key, long long value) : key(key), type(INTEGER), integer(value) {}
+    LogField(const char *key, unsigned long long value) : key(key), type(INTEGER), integer(static_cast<int64_t>(value)) {}
+    LogField(const char *key, double value) : key(key), type(REAL), real(value) {}
+    LogField(const char *key, const char *value) : key(key), type(TEXT), text(value) {}
+    LogField(const char *key, const std::string &value) : key(key), type(TEXT), text(value.c_str()) {}
+
+    const char *key;
+    Type type;
+    union
+    {
+        int64_t integer;
+        double real;
+        const char *text; // Only valid during the log call
+    };
+};
+
+void StartLog(); // Starts the sink; records made before it are kept and written once it runs
+void StopLog();  // Writes out everything logged so far and stops the sink; later records are written straight away
+void SetLogLevel(LogLevel level); // Runtime floor on top of GALAGA_LOG_LEVEL
+void WriteLog(LogLevel level, const char *message, std::initializer_list<LogField> fields = {});
+
+#define LOG_DEBUG(...)                                  \
+    do                                                  \
+    {                                                   \
+        if (GALAGA_LOG_LEVEL <= LOG_LEVEL_DEBUG)        \
+            WriteLog(LOG_LEVEL_DEBUG, __VA_ARGS__);     \
+    } while (0)
+#define LOG_INFO(...)                                   \
+    do                                                  \
+    {                                                   \
+        if (GALAGA_LOG_LEVEL <= LOG_LEVEL_INFO)         \
+            WriteLog(LOG_LEVEL_INFO, __VA_ARGS__);      \
+    } while (0)
+#define LOG_WARNING(...)                                \
+    do                                                  \
+    {                                                   \
+        if (GALAGA_LOG_LEVEL <= LOG_LEVEL_WARNING)      \
+            WriteLog(LOG_LEVEL_WARNING, __VA_ARGS__);   \
+    } while (0)
+#define LOG_ERROR(...)                                  \
+    do                                                  \
+    {                                                   \
+        if (GALAGA_LOG_LEVEL <= LOG_LEVEL_ERROR)        \
+            WriteLog(LOG_LEVEL_ERROR, __VA_ARGS__);     \
+    } while (0)
+
+#endif // LOGGER_H
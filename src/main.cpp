@@ -1,11 +1,28 @@
 #include <raylib.h>
 #include <cmath> // For fminf() and fmaxf()
-#include "Player.h"
 #include "Star.h"
-#include "Enemy.h"
+#include "benchmark.h"
+#include "capture.h"
+#include "dynamic_resolution.h"
+#include "frame_pacer.h"
+#include "input_sampler.h"
+#include "logger.h"
+#include "match_server.h"
+#include "world.h"
+#include "memory.h"
+#include "particles.h"
+#include "replay.h"
+#include "simulation.h"
+#include "sound_effects.h"
+#include "spectator.h"
+#include "telemetry.h"
+#include "tuner.h"
+#include <thread>
 #include <vector>
-#include <iostream>
 #include <string>
+#include <ctime>
+#include <cstdlib>
+#include <algorithm>
 
 // Game state enum
 enum GameState
@@ -15,84 +32,316 @@ enum GameState
     PAUSED,
     SETTINGS,
     GAME_OVER,
-    EXIT_CONFIRMATION // New state for exit confirmation
+    EXIT_CONFIRMATION, // New state for exit confirmation
+    REPLAY,            // Watching a recorded game
+    SPECTATING         // Watching another process's game over the network
+};
+
+// Viewer controls while watching a replay
+struct ReplayPlayback
+{
+    bool paused = false;
+    int speed = 1;          // Recorded ticks per real tick, doubled and halved between 1 and 32
+    double pendingTicks = 0; // Ticks owed to the viewer's clock but not yet played
 };
 
 // Constants
-const int VIRTUAL_WIDTH = 1920;
-const int VIRTUAL_HEIGHT = 1080;
+const int DEFAULT_TICK_RATE = 60;
+const int DEFAULT_FRAME_RATE = 60;
 const int MENU_BUTTON_WIDTH = 250;
 const int MENU_BUTTON_HEIGHT = 50;
+const int OVERLAY_TOP = 160; // Debug overlays stack down the left edge from here, below the HUD
 
 // Function prototypes
-void SpawnEnemies(std::vector<Enemy> &enemies, int level, int wave);
-void HandleGameplay(Player &player, std::vector<Enemy> &enemies, std::vector<Projectile> &enemyProjectiles,
-                    std::vector<Star> &stars, int &score, int &level, int &wave, bool &levelStartMusicPlayed,
-                    Music &levelStart, GameState &currentState, int screenWidth, int screenHeight,
-                    Texture2D &playerTexture); // Added playerTexture parameter
-void DrawMenu(Vector2 mousePoint, GameState &currentState, std::vector<Star> &stars, int screenWidth, int screenHeight);
-void DrawSettings(Vector2 mousePoint, GameState &currentState, std::vector<Star> &stars,
+PlayerInput SamplePlayerInput();
+void DrawMenu(Vector2 mousePoint, GameState &currentState, StarField &stars, int screenWidth, int screenHeight);
+void DrawSettings(Vector2 mousePoint, GameState &currentState, StarField &stars,
                   int &resolutionIndex, std::vector<std::pair<int, int>> &resolutionOptions,
                   bool &isFullscreen, bool &isBorderless, int screenWidth, int screenHeight,
-                  float &masterVolume, GameState &previousState); // Added masterVolume and previousState parameters
+                  float &masterVolume, GameState &previousState,
+                  DynamicResolution &dynamicResolution); // Added masterVolume and previousState parameters
 void DrawPauseMenu(Vector2 mousePoint, GameState &currentState, int screenWidth, int screenHeight);
-void DrawGameOver(int score, GameState &currentState, Player &player, std::vector<Enemy> &enemies,
-                  std::vector<Projectile> &enemyProjectiles, int &level, int &wave, bool &levelStartMusicPlayed);
+void DrawGameOver(int score, GameState &currentState, World &world, SimulationThread &simulation);
 void DrawExitConfirmation(Vector2 mousePoint, GameState &currentState, GameState &previousState, int screenWidth, int screenHeight);
-
-int main()
+void DrawMemoryOverlay(int screenWidth);
+void DrawLatencyOverlay(const LatencyStats &latency, bool rawInput);
+void DrawEntityOverlay(const EntityCounts &counts);
+void DrawPacingOverlay(const FramePacer &pacer, const LatencyStats frameCosts[2], bool direct);
+void UpdateReplay(Replay &replay, World &world, ReplayPlayback &playback, float frameTime, ParticleEffects &particles,
+                  SoundEffects &soundEffects);
+void DrawReplayOverlay(const Replay &replay, const World &world, const ReplayPlayback &playback);
+void DrawSpectatorOverlay(const SpectatorClient &spectator, double seconds);
+size_t TextureBytes(Texture2D texture);
+
+int main(int argc, char *argv[])
 {
+    // Log records are written out by a sink thread, flushed and stopped however main exits
+    StartLog();
+    std::atexit(StopLog);
+
+    // Command line options
+    int tickRate = DEFAULT_TICK_RATE; // Lower tick rates save CPU; collisions are swept so shots don't tunnel
+    double frameRate = DEFAULT_FRAME_RATE; // 0 follows the monitor's refresh rate
+    bool directRender = false;             // Draw straight into the window instead of through the render target
+    std::string tuningPath = "res/tuning.cfg";
+    std::string capturePath;
+    std::string recordPath;
+    std::string replayPath;
+    std::string heatmapPath;
+    unsigned long replayTick = 0;
+    int broadcastPort = 0;
+    std::string spectateHost = "127.0.0.1";
+    int spectatePort = 0;
+    int tunerGames = 0; // Games per setting when running the difficulty tuner
+    int serverMatches = 0; // Matches when running as a headless match server
+    unsigned long serverTicks = DEFAULT_TICK_RATE * 60;
+    unsigned serverThreads = std::max(1u, std::thread::hardware_concurrency());
+    bool serverScaling = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--tick-rate" && i + 1 < argc)
+        {
+            tickRate = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--fps" && i + 1 < argc)
+        {
+            frameRate = std::max(0.0, std::atof(argv[++i]));
+        }
+        else if (arg == "--direct-render")
+        {
+            directRender = true;
+        }
+        else if (arg == "--tune")
+        {
+            tunerGames = 100;
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+                tunerGames = std::atoi(argv[++i]);
+        }
+        else if (arg == "--server" && i + 1 < argc)
+        {
+            serverMatches = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--server-ticks" && i + 1 < argc)
+        {
+            serverTicks = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--server-threads" && i + 1 < argc)
+        {
+            serverThreads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--heatmap" && i + 1 < argc)
+        {
+            heatmapPath = argv[++i];
+        }
+        else if (arg == "--server-scaling")
+        {
+            serverScaling = true;
+        }
+        else if (arg == "--bench-spatial")
+        {
+            return RunSpatialBenchmark();
+        }
+        else if (arg == "--bench-bullets")
+        {
+            return RunBulletBenchmark();
+        }
+        else if (arg == "--test-sweep")
+        {
+            return RunSweepTest();
+        }
+        else if (arg == "--decode-telemetry" && i + 1 < argc)
+        {
+            return DecodeTelemetry(argv[++i]);
+        }
+        else if (arg == "--capture" && i + 1 < argc)
+        {
+            capturePath = argv[++i];
+        }
+        else if (arg == "--record" && i + 1 < argc)
+        {
+            recordPath = argv[++i];
+        }
+        else if (arg == "--replay" && i + 1 < argc)
+        {
+            replayPath = argv[++i];
+        }
+        else if (arg == "--replay-tick" && i + 1 < argc)
+        {
+            replayTick = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--broadcast" && i + 1 < argc)
+        {
+            broadcastPort = std::atoi(argv[++i]);
+        }
+        else if (arg == "--spectate" && i + 1 < argc)
+        {
+            // [HOST:]PORT
+            std::string address = argv[++i];
+            size_t colon = address.rfind(':');
+            if (colon != std::string::npos)
+                spectateHost = address.substr(0, colon);
+            spectatePort = std::atoi(address.c_str() + (colon == std::string::npos ? 0 : colon + 1));
+        }
+        else if (arg == "--tuning" && i + 1 < argc)
+        {
+            tuningPath = argv[++i];
+        }
+        else if (arg == "--telemetry" && i + 1 < argc)
+        {
+            const char *path = argv[++i];
+            if (!StartTelemetry(path))
+                LOG_ERROR("can't open telemetry file", {{"path", path}});
+        }
+    }
+    if (tunerGames > 0)
+    {
+        // Sweeps around the tuning file's values, so any --tuning option applies
+        Tuning base;
+        LoadTuning(tuningPath, base);
+        return RunDifficultyTuner(base, tunerGames);
+    }
+    if (serverMatches > 0)
+    {
+        Tuning tuning;
+        LoadTuning(tuningPath, tuning);
+        return RunMatchServer(tuning, serverMatches, serverTicks, serverThreads, serverScaling, heatmapPath);
+    }
+
+    // A replay brings its own tick rate, and its keyframes hold everything else the world needs
+    Replay replay;
+    if (!replayPath.empty())
+    {
+        if (!replay.Open(replayPath))
+            return 1;
+        tickRate = replay.TickRate();
+    }
+
     // Configure window
     SetConfigFlags(FLAG_WINDOW_RESIZABLE);
     InitWindow(VIRTUAL_WIDTH, VIRTUAL_HEIGHT, "Space Shooter");
 
-    // Create render texture for fixed resolution
-    RenderTexture2D target = LoadRenderTexture(VIRTUAL_WIDTH, VIRTUAL_HEIGHT);
+    // Frames are held to their schedule by the pacer rather than raylib's coarse sleep
+    if (frameRate <= 0)
+        frameRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    FramePacer pacer(frameRate > 0 ? frameRate : DEFAULT_FRAME_RATE);
+
+    // Create render texture for fixed resolution, resized by dynamic resolution when enabled
+    DynamicResolution dynamicResolution(VIRTUAL_WIDTH, VIRTUAL_HEIGHT, static_cast<float>(1 / pacer.Rate()));
+    RenderTexture2D target = LoadRenderTexture(dynamicResolution.GetWidth(), dynamicResolution.GetHeight());
+    SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+    TrackAllocation(MEMORY_ASSETS, TextureBytes(target.texture));
+
+    // Optional video capture of the render target, read back asynchronously and written by a worker thread
+    VideoCapture capture;
+    if (!capturePath.empty() && !capture.Start(capturePath, target.texture.width, target.texture.height,
+                                                   static_cast<int>(pacer.Rate() + 0.5)))
+    {
+        LOG_ERROR("can't open capture file", {{"path", capturePath}});
+    }
 
     // Disable default ESC key exiting behavior
     SetExitKey(KEY_NULL);
 
     // Initialize audio
     InitAudioDevice();
-    SetTargetFPS(60);
 
     // Load textures - use relative paths
     Texture2D playerTexture = LoadTexture("res/player_sprite.jpg");
     if (playerTexture.id == 0)
     {
-        std::cout << "Failed to load player texture. Check file path." << std::endl;
+        LOG_WARNING("can't load player texture, using a placeholder", {{"path", "res/player_sprite.jpg"}});
         // Fallback: create a blank texture
         Image img = GenImageColor(64, 64, YELLOW);
         playerTexture = LoadTextureFromImage(img);
         UnloadImage(img);
     }
+    TrackAllocation(MEMORY_ASSETS, TextureBytes(playerTexture));
 
     // Load music - use relative paths
     Music levelStart = LoadMusicStream("res/level_start.mp3");
     levelStart.looping = false;
     SetMusicVolume(levelStart, 0.1f);
+    SoundEffects soundEffects;
+    soundEffects.Load();
+
+    // Gameplay constants, reloaded whenever the file is saved
+    TuningWatcher tuningWatcher(tuningPath);
+    tuningWatcher.Start();
+    Tuning tuning;
+    tuningWatcher.Poll(tuning);
+
+    // World initialization, simulated on its own thread while playing; each next wave is built ahead on another
+    WaveBuilder waveBuilder;
+    waveBuilder.Start();
+    World world(playerTexture.width, playerTexture.height, static_cast<uint32_t>(time(nullptr)), tuning);
+    world.waveBuilder = &waveBuilder;
+    Heatmap heatmap; // Where the player flew, died and scored over the whole session
+    if (!heatmapPath.empty())
+        world.heatmap = &heatmap;
+    SimulationThread simulation(world, tickRate);
+    simulation.SetTuningSource(&tuningWatcher);
+    ReplayRecorder recorder(recordPath, tickRate);
+    if (!recordPath.empty())
+        simulation.SetReplayRecorder(&recorder);
+
+    // Gameplay events reach audio, particles and telemetry through their own queues, drained once per frame
+    EventBus eventBus;
+    EventQueue &audioEvents = eventBus.Subscribe();
+    EventQueue &effectEvents = eventBus.Subscribe();
+    EventQueue &telemetryEvents = eventBus.Subscribe();
+    simulation.SetEventBus(&eventBus);
+    ParticleEffects particles;
+
+    // Local spectators see every tick the simulation publishes
+    SpectatorServer spectators;
+    if (broadcastPort > 0)
+    {
+        if (spectators.Start(broadcastPort))
+            simulation.SetSpectatorServer(&spectators);
+        else
+            LOG_ERROR("can't open broadcast port", {{"port", broadcastPort}});
+    }
+
+    simulation.Start();
+    bool simulating = false;
 
-    // Player initialization
-    Player player(0.5f, 0.95f, playerTexture.width, playerTexture.height);
+    // Replays are played on this thread; the simulation thread stays paused and never touches the world
+    ReplayPlayback playback;
+    RenderSnapshot replaySnapshot;
+    if (!replayPath.empty() && !replay.Seek(world, replayTick))
+    {
+        LOG_ERROR("can't read replay", {{"path", replayPath}});
+        replayPath.clear();
+    }
+
+    // Spectating draws the host's frames and never runs the local world
+    SpectatorClient spectator;
+    RenderSnapshot spectatorSnapshot;
+    double spectateStart = GetTime();
+    if (spectatePort > 0 && !spectator.Connect(spectateHost, spectatePort))
+    {
+        LOG_ERROR("can't connect to broadcast", {{"host", spectateHost}, {"port", spectatePort}});
+        spectatePort = 0;
+    }
+
+    // Sample input on its own thread when raw input is readable, and measure how long it takes to reach the screen
+    InputSampler inputSampler(simulation);
+    bool rawInput = inputSampler.Start();
+    LatencyStats latency;
+    unsigned long measuredTick = 0;
+    int playedMusicCue = 0;
 
-    // Create stars
+    // Create background stars for the menus
     const int numStars = 100;
-    std::vector<Star> stars;
+    StarField stars;
     for (int i = 0; i < numStars; ++i)
     {
         stars.emplace_back(VIRTUAL_WIDTH, VIRTUAL_HEIGHT);
     }
 
-    // Create enemies and projectiles
-    std::vector<Enemy> enemies;
-    std::vector<Projectile> enemyProjectiles;
-
     // Game state variables
-    int level = 1;
-    int wave = 1;
-    int score = 0;
-    bool levelStartMusicPlayed = false;
-    GameState currentState = MENU;
+    GameState currentState = spectatePort > 0 ? SPECTATING : replayPath.empty() ? MENU : REPLAY;
     GameState previousState = MENU; // New variable to track previous state
 
     // Settings variables
@@ -101,13 +350,18 @@ int main()
     bool isFullscreen = false;
     bool isBorderless = false;
     float masterVolume = 1.0f; // Master volume (0.0f - 1.0f)
-
-    // Initialize first wave of enemies
-    SpawnEnemies(enemies, level, wave);
+    bool showMemoryOverlay = false;
+    bool showLatencyOverlay = false;
+    bool showEntityOverlay = false;
+    bool showPacingOverlay = false;
+    LatencyStats frameCosts[2]; // Per frame, through the render target and drawn direct
 
     // GAME LOOP
-    while (!WindowShouldClose())
+    bool quit = false;
+    while (!quit && !WindowShouldClose())
     {
+        double frameStart = GetTime();
+
         // Calculate window dimensions and scaling
         int windowWidth = GetScreenWidth();
         int windowHeight = GetScreenHeight();
@@ -148,6 +402,10 @@ int main()
             {
                 currentState = SETTINGS;
             }
+            else if (currentState == REPLAY || currentState == SPECTATING)
+            {
+                quit = true;
+            }
         }
 
         // Toggle fullscreen with F11
@@ -157,12 +415,89 @@ int main()
             isFullscreen = !isFullscreen;
         }
 
+        // Toggle the memory overlay with F3
+        if (IsKeyPressed(KEY_F3))
+        {
+            showMemoryOverlay = !showMemoryOverlay;
+        }
+
+        // Toggle the input latency overlay with F4
+        if (IsKeyPressed(KEY_F4))
+        {
+            showLatencyOverlay = !showLatencyOverlay;
+        }
+
+        // Toggle the entity counters with F5
+        if (IsKeyPressed(KEY_F5))
+        {
+            showEntityOverlay = !showEntityOverlay;
+        }
+
+        // Toggle the frame pacing histogram with F6
+        if (IsKeyPressed(KEY_F6))
+        {
+            showPacingOverlay = !showPacingOverlay;
+        }
+
+        // Switch between drawing through the render target and drawing straight into the window with F7
+        if (IsKeyPressed(KEY_F7))
+        {
+            directRender = !directRender;
+        }
+
         // Apply master volume
         SetMasterVolume(masterVolume);
 
-        // Begin rendering to fixed resolution texture
-        BeginTextureMode(target);
-        ClearBackground(BLACK);
+        // Hand this frame's controls to the simulation and grab the newest tick it finished
+        if (rawInput)
+            inputSampler.SetFocused(IsWindowFocused());
+        else
+            simulation.SubmitInput(SamplePlayerInput());
+        if (currentState == REPLAY)
+        {
+            UpdateReplay(replay, world, playback, GetFrameTime(), particles, soundEffects);
+            BuildSnapshot(world, replaySnapshot);
+        }
+        if (currentState == SPECTATING)
+        {
+            spectator.Poll();
+            spectator.BuildSnapshot(spectatorSnapshot);
+        }
+        const RenderSnapshot &snapshot = currentState == REPLAY       ? replaySnapshot
+                                         : currentState == SPECTATING ? spectatorSnapshot
+                                                                      : simulation.AcquireSnapshot();
+        audioEvents.Drain([&](const GameEvent &event) { soundEffects.Play(event); });
+        effectEvents.Drain([&](const GameEvent &event) { particles.Spawn(event); });
+        telemetryEvents.Drain(RecordEventTelemetry);
+        if (currentState == PLAYING || (currentState == REPLAY && !playback.paused))
+            particles.Update(GetFrameTime());
+
+        // Play level start music when the simulation asks for it
+        if (currentState == PLAYING && snapshot.musicCue != playedMusicCue)
+        {
+            PlayMusicStream(levelStart);
+            playedMusicCue = snapshot.musicCue;
+        }
+
+        // Draw in virtual coordinates, either into the render target that is scaled onto the window afterwards, or
+        // straight into the window with the camera doing the scaling. Capture reads the render target, so it needs it.
+        bool drawDirect = directRender && !capture.IsCapturing();
+        if (drawDirect)
+        {
+            BeginDrawing();
+            ClearBackground(BLACK);
+            Camera2D windowCamera = {{offsetX, offsetY}, {0, 0}, 0.0f, scale};
+            BeginMode2D(windowCamera);
+            BeginScissorMode((int)offsetX, (int)offsetY, (int)(VIRTUAL_WIDTH * scale), (int)(VIRTUAL_HEIGHT * scale)); // Keep the letterbox bars clear
+        }
+        else
+        {
+            // Fixed resolution texture, scaled down to the current target size
+            BeginTextureMode(target);
+            ClearBackground(BLACK);
+            Camera2D renderCamera = {{0, 0}, {0, 0}, 0.0f, (float)target.texture.width / VIRTUAL_WIDTH};
+            BeginMode2D(renderCamera);
+        }
 
         // Handle different game states
         switch (currentState)
@@ -174,7 +509,7 @@ int main()
         case SETTINGS:
             DrawSettings(mousePoint, currentState, stars, resolutionIndex,
                          resolutionOptions, isFullscreen, isBorderless,
-                         screenWidth, screenHeight, masterVolume, previousState);
+                         screenWidth, screenHeight, masterVolume, previousState, dynamicResolution);
             break;
 
         case EXIT_CONFIRMATION:
@@ -183,13 +518,8 @@ int main()
 
         case PAUSED:
             // Draw the gameplay scene first (frozen)
-            for (const auto &star : stars)
-                star.Draw();
-            for (const auto &enemy : enemies)
-                enemy.Draw();
-            for (const auto &projectile : enemyProjectiles)
-                projectile.Draw();
-            player.Draw(playerTexture);
+            DrawSnapshot(snapshot, playerTexture);
+            particles.Draw();
 
             DrawPauseMenu(mousePoint, currentState, screenWidth, screenHeight);
             break;
@@ -198,321 +528,174 @@ int main()
             // Draw stars in background
             for (auto &star : stars)
             {
-                star.Update(screenHeight);
+                star.Update(screenWidth, screenHeight);
                 star.Draw();
             }
 
-            DrawGameOver(score, currentState, player, enemies, enemyProjectiles,
-                         level, wave, levelStartMusicPlayed);
+            DrawGameOver(snapshot.score, currentState, world, simulation);
             break;
 
         case PLAYING:
-            HandleGameplay(player, enemies, enemyProjectiles, stars, score, level,
-                           wave, levelStartMusicPlayed, levelStart, currentState,
-                           screenWidth, screenHeight, playerTexture); // Pass playerTexture
+            DrawSnapshot(snapshot, playerTexture);
+            particles.Draw();
+            if (snapshot.gameOver)
+            {
+                currentState = GAME_OVER;
+            }
             break;
-        }
-
-        EndTextureMode();
-
-        // Draw the render texture to the window
-        BeginDrawing();
-        ClearBackground(BLACK);
-        Rectangle srcRec = {0, 0, (float)target.texture.width, -(float)target.texture.height};
-        Rectangle destRec = {offsetX, offsetY, VIRTUAL_WIDTH * scale, VIRTUAL_HEIGHT * scale};
-        Vector2 origin = {0, 0};
-        DrawTexturePro(target.texture, srcRec, destRec, origin, 0.0f, WHITE);
-        EndDrawing();
-
-        // Update music
-        UpdateMusicStream(levelStart);
-    }
-
-    // Cleanup resources
-    UnloadRenderTexture(target);
-    UnloadTexture(playerTexture);
-    UnloadMusicStream(levelStart);
-    CloseAudioDevice();
-    CloseWindow();
-
-    return 0;
-}
-
-void SpawnEnemies(std::vector<Enemy> &enemies, int level, int wave)
-{
-    // Increase number and difficulty of enemies based on level and wave
-    int baseEnemies = 5;
-    int numEnemies = baseEnemies + (level - 1) * 2 + wave;
-
-    // Cap max enemies to prevent overwhelming the screen
-    numEnemies = fminf(numEnemies, 20);
 
-    // Increase enemy speed with levels
-    float baseSpeed = 1.5f;
-    float speedMultiplier = 1.0f + (level * 0.1f);
-    float enemySpeed = baseSpeed * speedMultiplier;
-
-    // Add formation patterns based on level
-    int columns = 5;
+        case REPLAY:
+            DrawSnapshot(snapshot, playerTexture);
+            particles.Draw();
+            DrawReplayOverlay(replay, world, playback);
+            break;
 
-    // Create enemies in a grid formation
-    for (int i = 0; i < numEnemies; ++i)
-    {
-        int row = i / columns;
-        int col = i % columns;
-        float xPos = (GetScreenWidth() / (columns + 1)) * (col + 1);
-        float yPos = -100 - (row * 80); // Start above screen with spacing
+        case SPECTATING:
+            DrawSnapshot(snapshot, playerTexture);
+            DrawSpectatorOverlay(spectator, GetTime() - spectateStart);
+            break;
+        }
 
-        // Determine enemy color based on level
-        Color enemyColor;
-        if (level == 1)
+        if (showMemoryOverlay)
         {
-            enemyColor = (GetRandomValue(0, 1) == 0) ? RED : ORANGE;
+            DrawMemoryOverlay(screenWidth);
         }
-        else if (level == 2)
+        if (showLatencyOverlay)
         {
-            int colorChoice = GetRandomValue(0, 2);
-            enemyColor = (colorChoice == 0) ? RED : (colorChoice == 1) ? ORANGE
-                                                                       : PINK;
+            DrawLatencyOverlay(latency, rawInput);
         }
-        else
+        if (showEntityOverlay)
         {
-            int colorChoice = GetRandomValue(0, 3);
-            enemyColor = (colorChoice == 0) ? RED : (colorChoice == 1) ? ORANGE
-                                                : (colorChoice == 2)   ? PINK
-                                                                       : PURPLE;
+            DrawEntityOverlay(snapshot.entities);
         }
-
-        enemies.emplace_back(xPos, yPos, enemySpeed, enemyColor);
-    }
-
-    std::cout << "Spawned " << numEnemies << " enemies for level " << level
-              << ", wave " << wave << " with speed " << enemySpeed << std::endl;
-}
-
-void HandleGameplay(Player &player, std::vector<Enemy> &enemies, std::vector<Projectile> &enemyProjectiles,
-                    std::vector<Star> &stars, int &score, int &level, int &wave, bool &levelStartMusicPlayed,
-                    Music &levelStart, GameState &currentState, int screenWidth, int screenHeight,
-                    Texture2D &playerTexture)
-{ // Added playerTexture parameter
-
-    // Play level start music if needed
-    if (!levelStartMusicPlayed)
-    {
-        PlayMusicStream(levelStart);
-        levelStartMusicPlayed = true;
-    }
-
-    // Stop music after it plays once
-    if (GetMusicTimePlayed(levelStart) >= GetMusicTimeLength(levelStart))
-    {
-        StopMusicStream(levelStart);
-    }
-
-    // Update game objects
-    player.Update(screenWidth, screenHeight);
-
-    for (auto &star : stars)
-    {
-        star.Update(screenHeight);
-    }
-
-    for (auto &enemy : enemies)
-    {
-        enemy.Update();
-    }
-
-    if (!player.IsExploding())
-    {
-        // Check for collisions between player projectiles and enemies
-        auto &playerProjectiles = player.GetProjectiles();
-        for (auto it = playerProjectiles.begin(); it != playerProjectiles.end();)
+        if (showPacingOverlay)
         {
-            bool hit = false;
-            for (auto et = enemies.begin(); et != enemies.end();)
-            {
-                if (CheckCollisionRecs(it->GetBounds(), et->GetBounds()))
-                {
-                    // Handle enemy hit
-                    et->TakeDamage();
-
-                    if (et->IsDestroyed())
-                    {
-                        // Add enemy projectiles to global list before destroying enemy
-                        std::vector<Projectile> enemyProj = et->GetProjectiles();
-                        enemyProjectiles.insert(enemyProjectiles.end(), enemyProj.begin(), enemyProj.end());
-
-                        // Remove the enemy and award points
-                        et = enemies.erase(et);
-                        score += 100; // Base score per enemy
-                    }
-                    else
-                    {
-                        ++et; // Enemy still alive, move to next
-                    }
-
-                    // Remove the projectile that hit
-                    it = playerProjectiles.erase(it);
-                    hit = true;
-                    break;
-                }
-                else
-                {
-                    ++et; // No collision, check next enemy
-                }
-            }
-
-            if (!hit)
-            {
-                ++it; // No hit, check next projectile
-            }
+            DrawPacingOverlay(pacer, frameCosts, drawDirect);
         }
 
-        // Check for collisions between player and enemies
-        for (const auto &enemy : enemies)
+        if (drawDirect)
         {
-            if (CheckCollisionRecs(
-                    {static_cast<float>(player.GetX() - player.GetWidth() / 2),
-                     static_cast<float>(player.GetY() - player.GetHeight() / 2),
-                     static_cast<float>(player.GetWidth()),
-                     static_cast<float>(player.GetHeight())},
-                    enemy.GetBounds()))
-            {
-
-                player.LoseLife();
-                if (player.GetLives() <= 0)
-                {
-                    currentState = GAME_OVER;
-                    break;
-                }
-            }
+            EndScissorMode();
+            EndMode2D();
         }
-
-        // Check for collisions between player and enemy projectiles
-        for (auto it = enemyProjectiles.begin(); it != enemyProjectiles.end();)
+        else
         {
-            if (CheckCollisionRecs(
-                    it->GetBounds(),
-                    {static_cast<float>(player.GetX() - player.GetWidth() / 2),
-                     static_cast<float>(player.GetY() - player.GetHeight() / 2),
-                     static_cast<float>(player.GetWidth()),
-                     static_cast<float>(player.GetHeight())}))
-            {
-
-                it = enemyProjectiles.erase(it);
-                player.LoseLife();
-                if (player.GetLives() <= 0)
-                {
-                    currentState = GAME_OVER;
-                    break;
-                }
-            }
-            else
-            {
-                ++it;
-            }
+            EndMode2D();
+            EndTextureMode();
+            capture.CaptureFrame(target);
+
+            // Draw the render texture to the window
+            BeginDrawing();
+            ClearBackground(BLACK);
+            Rectangle srcRec = {0, 0, (float)target.texture.width, -(float)target.texture.height};
+            Rectangle destRec = {offsetX, offsetY, VIRTUAL_WIDTH * scale, VIRTUAL_HEIGHT * scale};
+            Vector2 origin = {0, 0};
+            DrawTexturePro(target.texture, srcRec, destRec, origin, 0.0f, WHITE);
         }
+        float workTime = (float)(GetTime() - frameStart);
+        double waitStart = GetTime();
+        pacer.Wait();
+        double waited = GetTime() - waitStart;
+        EndDrawing();
+
+        // What the frame cost through this path, including the buffer swap but not the pacing wait
+        frameCosts[drawDirect].Add(static_cast<int64_t>((GetTime() - frameStart - waited) * 1e9));
 
-        // Update enemy projectiles even if the enemy is destroyed
-        for (auto it = enemyProjectiles.begin(); it != enemyProjectiles.end();)
+        // The first frame to present a tick that consumed new input closes the input-to-present measurement
+        if (snapshot.inputTime != 0 && snapshot.tick != measuredTick)
         {
-            it->Update();
-            if (it->IsOffScreen(screenHeight))
-            {
-                it = enemyProjectiles.erase(it);
-            }
-            else
-            {
-                ++it;
-            }
+            int64_t inputLatency = InputClockNow() - snapshot.inputTime;
+            latency.Add(inputLatency);
+            RecordTelemetry(TELEMETRY_LATENCY, static_cast<int32_t>(inputLatency / 1000));
         }
+        measuredTick = snapshot.tick;
+
+        SetTelemetryTick(static_cast<uint32_t>(snapshot.tick));
+        RecordTelemetry(TELEMETRY_FRAME, static_cast<int32_t>(GetFrameTime() * 1e6f), static_cast<int32_t>(workTime * 1e6f));
 
-        // Check if all enemies are destroyed or off-screen
-        bool allEnemiesGone = enemies.empty();
-        if (!allEnemiesGone)
+        // Resize the render target if the measured frame time moved us to another scale; drawing direct is always native
+        if (!drawDirect)
+            dynamicResolution.Update(GetFrameTime(), workTime);
+        if (target.texture.width != dynamicResolution.GetWidth())
         {
-            allEnemiesGone = true;
-            for (const auto &enemy : enemies)
-            {
-                if (!enemy.IsOffScreen(screenHeight))
-                {
-                    allEnemiesGone = false;
-                    break;
-                }
-            }
+            TrackFree(MEMORY_ASSETS, TextureBytes(target.texture));
+            UnloadRenderTexture(target);
+            target = LoadRenderTexture(dynamicResolution.GetWidth(), dynamicResolution.GetHeight());
+            SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+            TrackAllocation(MEMORY_ASSETS, TextureBytes(target.texture));
         }
 
-        // Spawn next wave if all enemies are gone
-        if (allEnemiesGone && !player.IsExploding())
+        // Update music, stopping it after it plays once
+        UpdateMusicStream(levelStart);
+        if (GetMusicTimePlayed(levelStart) >= GetMusicTimeLength(levelStart))
         {
-            wave++;
-            if (wave > level + 2)
-            {
-                level++;
-                wave = 1;
-                levelStartMusicPlayed = false;
-            }
-            SpawnEnemies(enemies, level, wave);
+            StopMusicStream(levelStart);
         }
-    }
 
-    // Handle player respawn
-    if (player.IsExploding() && player.GetExplosionTime() >= 2.0f)
-    {
-        bool enemiesCleared = true;
-        for (const auto &enemy : enemies)
-        {
-            if (!enemy.IsOffScreen(screenHeight) &&
-                CheckCollisionRecs(
-                    {static_cast<float>(player.GetX() - player.GetWidth()),
-                     static_cast<float>(player.GetY() - player.GetHeight()),
-                     static_cast<float>(player.GetWidth() * 2),
-                     static_cast<float>(player.GetHeight() * 2)},
-                    enemy.GetBounds()))
-            {
-                enemiesCleared = false;
-                break;
-            }
-        }
-        if (enemiesCleared)
+        // Only run the simulation while actually playing; pausing waits for the current tick to finish
+        if ((currentState == PLAYING) != simulating)
         {
-            player.Respawn();
+            simulating = (currentState == PLAYING);
+            if (simulating)
+                simulation.Resume();
+            else
+                simulation.Pause();
         }
     }
 
-    // Draw everything
-    for (const auto &star : stars)
-    {
-        star.Draw();
-    }
-
-    for (const auto &enemy : enemies)
-    {
-        enemy.Draw();
-    }
-
-    for (const auto &projectile : enemyProjectiles)
-    {
-        projectile.Draw();
-    }
+    // Cleanup resources
+    inputSampler.Stop();
+    simulation.Stop();
+    spectators.Stop();
+    spectator.Close();
+    waveBuilder.Stop();
+    if (!heatmapPath.empty() && !heatmap.Export(heatmapPath))
+        LOG_ERROR("can't write heatmap", {{"path", heatmapPath}});
+    recorder.Close();
+    tuningWatcher.Stop();
+    telemetryEvents.Drain(RecordEventTelemetry); // Whatever the last ticks raised
+    StopTelemetry();
+    uint32_t droppedEvents = audioEvents.Dropped() + effectEvents.Dropped() + telemetryEvents.Dropped();
+    if (droppedEvents > 0)
+        LOG_WARNING("gameplay events dropped by slow consumers", {{"count", droppedEvents}});
+    capture.Stop(); // Logs its summary, so before the log stops
+    StopLog(); // Before the reports below, so they aren't interleaved with late log lines
+    DumpMemoryStats(); // Peaks cover the whole session
+    latency.Print("Input latency");
+    pacer.Print();
+    frameCosts[0].Print("Frame cost through the render target");
+    frameCosts[1].Print("Frame cost drawn direct");
+    TrackFree(MEMORY_ASSETS, TextureBytes(target.texture));
+    UnloadRenderTexture(target);
+    TrackFree(MEMORY_ASSETS, TextureBytes(playerTexture));
+    UnloadTexture(playerTexture);
+    UnloadMusicStream(levelStart);
+    soundEffects.Unload();
+    CloseAudioDevice();
+    CloseWindow();
 
-    player.Draw(playerTexture);
+    return 0;
+}
 
-    // Draw HUD (score, lives, level, wave)
-    DrawText(TextFormat("Score: %06i", score), 10, 10, 20, WHITE);
-    DrawText(TextFormat("Lives: %i", player.GetLives()), 10, 40, 20, WHITE);
-    DrawText(TextFormat("Level: %i", level), 10, 70, 20, WHITE);
-    DrawText(TextFormat("Wave: %i/%i", wave, level + 2), 10, 100, 20, WHITE);
+PlayerInput SamplePlayerInput()
+{
+    PlayerInput input;
+    input.left = IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT);
+    input.right = IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT);
+    input.up = IsKeyDown(KEY_W) || IsKeyDown(KEY_UP);
+    input.down = IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN);
+    input.fire = IsKeyPressed(KEY_SPACE) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+    return input;
 }
 
-void DrawMenu(Vector2 mousePoint, GameState &currentState, std::vector<Star> &stars,
+void DrawMenu(Vector2 mousePoint, GameState &currentState, StarField &stars,
               int screenWidth, int screenHeight)
 {
 
     // Update and draw stars in the background
     for (auto &star : stars)
     {
-        star.Update(screenHeight);
+        star.Update(screenWidth, screenHeight);
         star.Draw();
     }
 
@@ -562,15 +745,15 @@ void DrawMenu(Vector2 mousePoint, GameState &currentState, std::vector<Star> &st
     }
 }
 
-void DrawSettings(Vector2 mousePoint, GameState &currentState, std::vector<Star> &stars,
+void DrawSettings(Vector2 mousePoint, GameState &currentState, StarField &stars,
                   int &resolutionIndex, std::vector<std::pair<int, int>> &resolutionOptions,
                   bool &isFullscreen, bool &isBorderless, int screenWidth, int screenHeight,
-                  float &masterVolume, GameState &previousState)
+                  float &masterVolume, GameState &previousState, DynamicResolution &dynamicResolution)
 {
     // Update and draw stars in the background
     for (auto &star : stars)
     {
-        star.Update(screenHeight);
+        star.Update(screenWidth, screenHeight);
         star.Draw();
     }
 
@@ -580,24 +763,25 @@ void DrawSettings(Vector2 mousePoint, GameState &currentState, std::vector<Star>
     Rectangle resolutionBtn = {(float)(screenWidth / 2 - btnWidth / 2), (float)(screenHeight / 2 - 190), (float)btnWidth, (float)btnHeight};
     Rectangle fullscreenBtn = {(float)(screenWidth / 2 - btnWidth / 2), (float)(screenHeight / 2 - 120), (float)btnWidth, (float)btnHeight};
     Rectangle borderlessBtn = {(float)(screenWidth / 2 - btnWidth / 2), (float)(screenHeight / 2 - 50), (float)btnWidth, (float)btnHeight};
-    Rectangle volumeDecBtn = {(float)(screenWidth / 2 - btnWidth / 2), (float)(screenHeight / 2 + 20), (float)btnWidth / 3, (float)btnHeight};
-    Rectangle volumeIncBtn = {(float)(screenWidth / 2 + btnWidth / 6), (float)(screenHeight / 2 + 20), (float)btnWidth / 3, (float)btnHeight};
-    Rectangle backBtn = {(float)(screenWidth / 2 - btnWidth / 2), (float)(screenHeight / 2 + 90), (float)btnWidth, (float)btnHeight};
-    Rectangle exitBtn = {(float)(screenWidth / 2 - btnWidth / 2), (float)(screenHeight / 2 + 160), (float)btnWidth, (float)btnHeight};
+    Rectangle dynamicResBtn = {(float)(screenWidth / 2 - btnWidth / 2), (float)(screenHeight / 2 + 20), (float)btnWidth, (float)btnHeight};
+    Rectangle volumeDecBtn = {(float)(screenWidth / 2 - btnWidth / 2), (float)(screenHeight / 2 + 90), (float)btnWidth / 3, (float)btnHeight};
+    Rectangle volumeIncBtn = {(float)(screenWidth / 2 + btnWidth / 6), (float)(screenHeight / 2 + 90), (float)btnWidth / 3, (float)btnHeight};
+    Rectangle backBtn = {(float)(screenWidth / 2 - btnWidth / 2), (float)(screenHeight / 2 + 160), (float)btnWidth, (float)btnHeight};
+    Rectangle exitBtn = {(float)(screenWidth / 2 - btnWidth / 2), (float)(screenHeight / 2 + 230), (float)btnWidth, (float)btnHeight};
 
     // Draw Settings title
     DrawText("Settings", screenWidth / 2 - MeasureText("Settings", 40) / 2, screenHeight / 2 - 270, 40, WHITE);
 
     // Draw Resolution button
-    std::string resText = "Resolution: " + std::to_string(resolutionOptions[resolutionIndex].first) +
-                          "x" + std::to_string(resolutionOptions[resolutionIndex].second);
+    UiString resText = UiString("Resolution: ") + std::to_string(resolutionOptions[resolutionIndex].first).c_str() +
+                       "x" + std::to_string(resolutionOptions[resolutionIndex].second).c_str();
     Color btnColor = CheckCollisionPointRec(mousePoint, resolutionBtn) ? GRAY : LIGHTGRAY;
     DrawRectangleRec(resolutionBtn, btnColor);
     int textWidth = MeasureText(resText.c_str(), 20);
     DrawText(resText.c_str(), resolutionBtn.x + btnWidth / 2 - textWidth / 2, resolutionBtn.y + btnHeight / 2 - 10, 20, BLACK);
 
     // Draw Fullscreen button
-    std::string fullText = "Fullscreen: ";
+    UiString fullText = "Fullscreen: ";
     fullText += isFullscreen ? "On" : "Off";
     btnColor = CheckCollisionPointRec(mousePoint, fullscreenBtn) ? GRAY : LIGHTGRAY;
     DrawRectangleRec(fullscreenBtn, btnColor);
@@ -605,15 +789,23 @@ void DrawSettings(Vector2 mousePoint, GameState &currentState, std::vector<Star>
     DrawText(fullText.c_str(), fullscreenBtn.x + btnWidth / 2 - textWidth / 2, fullscreenBtn.y + btnHeight / 2 - 10, 20, BLACK);
 
     // Draw Borderless button
-    std::string borderText = "Borderless: ";
+    UiString borderText = "Borderless: ";
     borderText += isBorderless ? "On" : "Off";
     btnColor = CheckCollisionPointRec(mousePoint, borderlessBtn) ? GRAY : LIGHTGRAY;
     DrawRectangleRec(borderlessBtn, btnColor);
     textWidth = MeasureText(borderText.c_str(), 20);
     DrawText(borderText.c_str(), borderlessBtn.x + btnWidth / 2 - textWidth / 2, borderlessBtn.y + btnHeight / 2 - 10, 20, BLACK);
 
+    // Draw Dynamic Resolution button
+    UiString dynamicResText = "Dynamic Res: ";
+    dynamicResText += dynamicResolution.IsEnabled() ? TextFormat("On (%i%%)", static_cast<int>(dynamicResolution.GetScale() * 100)) : "Off";
+    btnColor = CheckCollisionPointRec(mousePoint, dynamicResBtn) ? GRAY : LIGHTGRAY;
+    DrawRectangleRec(dynamicResBtn, btnColor);
+    textWidth = MeasureText(dynamicResText.c_str(), 20);
+    DrawText(dynamicResText.c_str(), dynamicResBtn.x + btnWidth / 2 - textWidth / 2, dynamicResBtn.y + btnHeight / 2 - 10, 20, BLACK);
+
     // Draw Volume control
-    DrawText("Volume:", screenWidth / 2 - btnWidth / 2, screenHeight / 2 + 0, 20, WHITE);
+    DrawText("Volume:", screenWidth / 2 - btnWidth / 2, screenHeight / 2 + 70, 20, WHITE);
 
     // Volume down button
     btnColor = CheckCollisionPointRec(mousePoint, volumeDecBtn) ? GRAY : LIGHTGRAY;
@@ -623,10 +815,10 @@ void DrawSettings(Vector2 mousePoint, GameState &currentState, std::vector<Star>
 
     // Volume display
     int volumePercentage = static_cast<int>(masterVolume * 100);
-    std::string volumeText = std::to_string(volumePercentage) + "%";
+    UiString volumeText = UiString(std::to_string(volumePercentage).c_str()) + "%";
     DrawText(volumeText.c_str(),
              screenWidth / 2 - MeasureText(volumeText.c_str(), 20) / 2,
-             screenHeight / 2 + 20, 20, WHITE);
+             screenHeight / 2 + 90, 20, WHITE);
 
     // Volume up button
     btnColor = CheckCollisionPointRec(mousePoint, volumeIncBtn) ? GRAY : LIGHTGRAY;
@@ -672,6 +864,10 @@ void DrawSettings(Vector2 mousePoint, GameState &currentState, std::vector<Star>
                 isBorderless = false;
             }
         }
+        else if (CheckCollisionPointRec(mousePoint, dynamicResBtn))
+        {
+            dynamicResolution.SetEnabled(!dynamicResolution.IsEnabled());
+        }
         else if (CheckCollisionPointRec(mousePoint, volumeDecBtn))
         {
             masterVolume = fmaxf(masterVolume - 0.1f, 0.0f);
@@ -795,15 +991,14 @@ void DrawPauseMenu(Vector2 mousePoint, GameState &currentState, int screenWidth,
     }
 }
 
-void DrawGameOver(int score, GameState &currentState, Player &player, std::vector<Enemy> &enemies,
-                  std::vector<Projectile> &enemyProjectiles, int &level, int &wave, bool &levelStartMusicPlayed)
+void DrawGameOver(int score, GameState &currentState, World &world, SimulationThread &simulation)
 {
 
     // Draw game over screen
     DrawText("GAME OVER", VIRTUAL_WIDTH / 2 - MeasureText("GAME OVER", 60) / 2, VIRTUAL_HEIGHT / 2 - 100, 60, RED);
 
     // Draw final score
-    std::string scoreText = "Final Score: " + std::to_string(score);
+    UiString scoreText = UiString("Final Score: ") + std::to_string(score).c_str();
     DrawText(scoreText.c_str(), VIRTUAL_WIDTH / 2 - MeasureText(scoreText.c_str(), 30) / 2, VIRTUAL_HEIGHT / 2, 30, WHITE);
 
     // Draw restart instruction
@@ -813,14 +1008,159 @@ void DrawGameOver(int score, GameState &currentState, Player &player, std::vecto
     // Handle restart
     if (IsKeyPressed(KEY_ENTER))
     {
-        // Reset game state
-        player = Player(0.5f, 0.95f, 64, 64); // Use default size if texture was unavailable
-        enemies.clear();
-        enemyProjectiles.clear();
-        level = 1;
-        wave = 1;
-        SpawnEnemies(enemies, level, wave);
-        levelStartMusicPlayed = false;
+        // Reset game state; the simulation is paused outside PLAYING so the world is ours to touch
+        world.Reset(static_cast<uint32_t>(time(nullptr)));
+        simulation.Republish();
         currentState = PLAYING;
     }
 }
+
+void DrawMemoryOverlay(int screenWidth)
+{
+    const int width = 420;
+    const int lineHeight = 20;
+    int x = screenWidth - width - 10;
+    int y = 10;
+    DrawRectangle(x - 10, y - 5, width + 10, (MEMORY_TAG_COUNT + 1) * lineHeight + 10, Fade(BLACK, 0.7f));
+    DrawText("Memory       current KB   peak KB   live", x, y, 18, YELLOW);
+
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; ++tag)
+    {
+        MemoryStats stats = GetMemoryStats(static_cast<MemoryTag>(tag));
+        UiString line = GetMemoryTagName(static_cast<MemoryTag>(tag));
+        line.resize(12, ' ');
+        line += TextFormat("%10.1f %9.1f %6i", stats.currentBytes / 1024.0f, stats.peakBytes / 1024.0f,
+                           static_cast<int>(stats.liveAllocations));
+        DrawText(line.c_str(), x, y + (tag + 1) * lineHeight, 18, WHITE);
+    }
+}
+
+void DrawLatencyOverlay(const LatencyStats &latency, bool rawInput)
+{
+    const int top = OVERLAY_TOP;
+    DrawRectangle(0, top, 560, 60, Fade(BLACK, 0.7f));
+    DrawText(rawInput ? "Input latency (1 kHz raw input)" : "Input latency (sampled per frame)", 10, top + 8, 18, YELLOW);
+    DrawText(TextFormat("last %.1f  avg %.1f  p99 %.1f  max %.1f ms", latency.LastMs(), latency.AverageMs(),
+                        latency.PercentileMs(99), latency.MaxMs()),
+             10, top + 32, 18, WHITE);
+}
+
+void DrawEntityOverlay(const EntityCounts &counts)
+{
+    const int top = OVERLAY_TOP + 70;
+    DrawRectangle(0, top, 560, 36, Fade(BLACK, 0.7f));
+    DrawText(TextFormat("entities: %i live  %i asleep  %i drawn  %i retired", counts.live, counts.sleeping, counts.drawn,
+                        counts.retired),
+             10, top + 8, 18, WHITE);
+}
+
+void DrawPacingOverlay(const FramePacer &pacer, const LatencyStats frameCosts[2], bool direct)
+{
+    const int barWidth = 12;
+    const int graphHeight = 80;
+    const int top = OVERLAY_TOP + 116;
+    int width = FramePacer::JITTER_BUCKETS * barWidth + 20;
+    DrawRectangle(0, top, width, graphHeight + 94, Fade(BLACK, 0.7f));
+    DrawText(TextFormat("Frame pacing %.0f Hz: jitter p50 %.2f  p99 %.2f  max %.2f ms  spin %.2f ms", pacer.Rate(),
+                        pacer.JitterPercentileMs(50), pacer.JitterPercentileMs(99), pacer.WorstJitterMs(), pacer.SpinMs()),
+             10, top + 8, 18, YELLOW);
+
+    // Both render paths, so switching with F7 gives a side by side comparison
+    DrawText(TextFormat("%s  frame cost: render target avg %.2f p99 %.1f ms   direct avg %.2f p99 %.1f ms",
+                        direct ? "DIRECT" : "TARGET", frameCosts[0].AverageMs(), frameCosts[0].PercentileMs(99),
+                        frameCosts[1].AverageMs(), frameCosts[1].PercentileMs(99)),
+             10, top + 32, 18, WHITE);
+
+    // Interval minus period, early frames left of the centre line and late ones right; bars are log scaled
+    unsigned long most = 1;
+    for (int bucket = 0; bucket < FramePacer::JITTER_BUCKETS; ++bucket)
+    {
+        most = std::max(most, pacer.Bucket(bucket));
+    }
+    int baseline = top + 58 + graphHeight;
+    for (int bucket = 0; bucket < FramePacer::JITTER_BUCKETS; ++bucket)
+    {
+        int height = static_cast<int>(graphHeight * log1p(pacer.Bucket(bucket)) / log1p(most));
+        Color color = bucket == FramePacer::JITTER_BUCKETS / 2 ? GREEN : ORANGE;
+        DrawRectangle(10 + bucket * barWidth, baseline - height, barWidth - 2, height, color);
+    }
+    float range = FramePacer::JITTER_BUCKETS / 2 * FramePacer::JITTER_BUCKET_US / 1000.0f;
+    DrawText(TextFormat("-%.1f ms", range), 10, baseline + 4, 16, LIGHTGRAY);
+    DrawText(TextFormat("+%.1f ms", range), width - 70, baseline + 4, 16, LIGHTGRAY);
+}
+
+void UpdateReplay(Replay &replay, World &world, ReplayPlayback &playback, float frameTime, ParticleEffects &particles,
+                  SoundEffects &soundEffects)
+{
+    const unsigned long seekTicks = 10 * replay.TickRate();
+    if (IsKeyPressed(KEY_SPACE))
+        playback.paused = !playback.paused;
+    if (IsKeyPressed(KEY_UP))
+        playback.speed = std::min(playback.speed * 2, 32);
+    if (IsKeyPressed(KEY_DOWN))
+        playback.speed = std::max(playback.speed / 2, 1);
+
+    // Seeking restores the nearest keyframe and simulates from there, so any jump costs at most one keyframe interval
+    if (IsKeyPressed(KEY_HOME))
+        replay.Seek(world, replay.FirstTick());
+    if (IsKeyPressed(KEY_LEFT))
+        replay.Seek(world, world.tick > seekTicks ? world.tick - seekTicks : 0);
+    if (IsKeyPressed(KEY_RIGHT))
+        replay.Seek(world, world.tick + seekTicks);
+
+    if (playback.paused)
+    {
+        playback.pendingTicks = 0;
+        return;
+    }
+    playback.pendingTicks += static_cast<double>(frameTime) * replay.TickRate() * playback.speed;
+    while (playback.pendingTicks >= 1)
+    {
+        playback.pendingTicks -= 1;
+        if (!replay.Step(world))
+        {
+            playback.paused = true; // End of the recording
+            playback.pendingTicks = 0;
+            break;
+        }
+
+        // The replay runs on this thread, so its events go straight to the effects; seeks skip them
+        for (const GameEvent &event : world.events)
+        {
+            particles.Spawn(event);
+            soundEffects.Play(event);
+        }
+    }
+}
+
+void DrawReplayOverlay(const Replay &replay, const World &world, const ReplayPlayback &playback)
+{
+    float seconds = static_cast<float>(world.tick) / replay.TickRate();
+    float length = static_cast<float>(replay.EndTick()) / replay.TickRate();
+    float progress = replay.EndTick() > 0 ? seconds / length : 0;
+    DrawRectangle(0, VIRTUAL_HEIGHT - 60, VIRTUAL_WIDTH, 60, Fade(BLACK, 0.7f));
+    DrawRectangle(0, VIRTUAL_HEIGHT - 60, static_cast<int>(VIRTUAL_WIDTH * progress), 4, YELLOW);
+    DrawText(TextFormat("%s  %dx   %02d:%04.1f / %02d:%04.1f   tick %lu", playback.paused ? "PAUSED" : "REPLAY", playback.speed,
+                        static_cast<int>(seconds) / 60, fmodf(seconds, 60), static_cast<int>(length) / 60, fmodf(length, 60),
+                        world.tick),
+             10, VIRTUAL_HEIGHT - 44, 20, WHITE);
+    const char *help = "SPACE pause   LEFT/RIGHT seek 10 s   UP/DOWN speed   HOME restart   ESC quit";
+    DrawText(help, VIRTUAL_WIDTH - MeasureText(help, 20) - 10, VIRTUAL_HEIGHT - 44, 20, LIGHTGRAY);
+}
+
+void DrawSpectatorOverlay(const SpectatorClient &spectator, double seconds)
+{
+    DrawRectangle(0, VIRTUAL_HEIGHT - 60, VIRTUAL_WIDTH, 60, Fade(BLACK, 0.7f));
+    const char *status = spectator.Connected() ? spectator.HasFrame() ? "SPECTATING" : "WAITING FOR HOST" : "DISCONNECTED";
+    float kilobytes = spectator.BytesReceived() / 1024.0f;
+    DrawText(TextFormat("%s   frame %u   %.1f KB/s   %.0f bytes/frame", status, spectator.Frame(),
+                        seconds > 0 ? kilobytes / seconds : 0.0, spectator.HasFrame() ? spectator.BytesReceived() / (double)spectator.FramesReceived() : 0.0),
+             10, VIRTUAL_HEIGHT - 44, 20, WHITE);
+    const char *help = "ESC quit";
+    DrawText(help, VIRTUAL_WIDTH - MeasureText(help, 20) - 10, VIRTUAL_HEIGHT - 44, 20, LIGHTGRAY);
+}
+
+size_t TextureBytes(Texture2D texture)
+{
+    return static_cast<size_t>(texture.width) * texture.height * 4; // Estimate as RGBA8, which is what we load
+}
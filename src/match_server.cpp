@@ -0,0 +1,240 @@
+#include "match_server.h"
+#include "logger.h"
+#include "memory.h"
+#include "scripted_player.h"
+#include "world.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const int TICK_RATE = 60;
+    const int LATENCY_BUCKETS = 20000; // Tick times in tenths of a microsecond, the last bucket collects everything slower
+
+    struct Match
+    {
+        std::unique_ptr<World> world;
+        ScriptedPlayer player;
+        uint32_t seed;
+    };
+
+    // What one shard measured; written by its thread once, when the shard is done
+    struct ShardResult
+    {
+        int matches;
+        unsigned long ticks;
+        unsigned long games; // Matches that ended and started over
+        double seconds;      // From the start signal until this shard finished
+        std::vector<unsigned long> latency;
+        Heatmap heatmap;     // Of every match in the shard
+    };
+
+    // Holds every shard back until all of them have built their matches, so building isn't timed
+    class StartGate
+    {
+    public:
+        explicit StartGate(unsigned shards) : waiting(shards) {}
+
+        Clock::time_point Wait()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (--waiting == 0)
+            {
+                start = Clock::now();
+                opened.notify_all();
+            }
+            opened.wait(lock, [this] { return waiting == 0; });
+            return start;
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable opened;
+        unsigned waiting;
+        Clock::time_point start;
+    };
+
+    void RunShard(const Tuning &tuning, int firstMatch, int matchCount, int seedStride, unsigned long ticks,
+                  StartGate &gate, ShardResult &result)
+    {
+        // Everything the shard allocates is counted privately until it finishes
+        MemoryLedger ledger;
+        Heatmap heatmap;
+        std::vector<Match> matches(matchCount);
+        for (int i = 0; i < matchCount; ++i)
+        {
+            matches[i].seed = static_cast<uint32_t>(firstMatch + i + 1);
+            matches[i].world.reset(new World(100, 100, matches[i].seed, tuning, true));
+            matches[i].world->heatmap = &heatmap;
+        }
+        std::vector<unsigned long> latency(LATENCY_BUCKETS);
+        unsigned long games = 0;
+        const Scalar deltaTime = Scalar(1) / Scalar(TICK_RATE);
+
+        // Round robin, so every match advances at the same pace as it would on a tick-paced server
+        Clock::time_point start = gate.Wait();
+        for (unsigned long tick = 0; tick < ticks; ++tick)
+        {
+            for (Match &match : matches)
+            {
+                World &world = *match.world;
+                PlayerInput input = match.player.Decide(world); // Stands in for a client's input, not timed
+                Clock::time_point before = Clock::now();
+                HandleGameplay(world, input, deltaTime);
+                long long nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - before).count();
+                latency[std::min<long long>(nanoseconds / 100, LATENCY_BUCKETS - 1)]++;
+                if (world.gameOver)
+                {
+                    match.seed += seedStride;
+                    world.Reset(match.seed);
+                    games++;
+                }
+            }
+        }
+
+        result.matches = matchCount;
+        result.ticks = ticks * matchCount;
+        result.games = games;
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.latency.swap(latency);
+        result.heatmap = heatmap;
+    }
+
+    std::vector<ShardResult> RunShards(const Tuning &tuning, int matches, unsigned long ticks, unsigned threads)
+    {
+        std::vector<ShardResult> results(threads);
+        StartGate gate(threads);
+        std::vector<std::thread> workers;
+        for (unsigned shard = 0; shard < threads; ++shard)
+        {
+            int first = static_cast<int>(static_cast<long long>(matches) * shard / threads);
+            int last = static_cast<int>(static_cast<long long>(matches) * (shard + 1) / threads);
+            workers.emplace_back(RunShard, std::cref(tuning), first, last - first, matches, ticks, std::ref(gate),
+                                 std::ref(results[shard]));
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        return results;
+    }
+
+    double TicksPerSecond(const std::vector<ShardResult> &results)
+    {
+        unsigned long ticks = 0;
+        double seconds = 0;
+        for (const ShardResult &result : results)
+        {
+            ticks += result.ticks;
+            seconds = std::max(seconds, result.seconds);
+        }
+        return seconds > 0 ? ticks / seconds : 0;
+    }
+
+    // Microseconds below which the given percentage of the histogram falls
+    double Percentile(const std::vector<unsigned long> &latency, double percentile)
+    {
+        unsigned long count = 0;
+        for (unsigned long bucket : latency)
+        {
+            count += bucket;
+        }
+        unsigned long target = static_cast<unsigned long>(count * percentile / 100);
+        unsigned long seen = 0;
+        for (size_t bucket = 0; bucket < latency.size(); ++bucket)
+        {
+            seen += latency[bucket];
+            if (seen > target)
+                return bucket / 10.0;
+        }
+        return (latency.size() - 1) / 10.0;
+    }
+
+    double Slowest(const std::vector<unsigned long> &latency)
+    {
+        for (size_t bucket = latency.size(); bucket-- > 0;)
+        {
+            if (latency[bucket] > 0)
+                return bucket / 10.0;
+        }
+        return 0;
+    }
+}
+
+int RunMatchServer(const Tuning &tuning, int matches, unsigned long ticksPerMatch, unsigned threads, bool scaling,
+                   const std::string &heatmapPrefix)
+{
+    matches = std::max(1, matches);
+    threads = std::max(1u, std::min(threads, static_cast<unsigned>(matches)));
+    std::printf("Match server: %d matches x %lu ticks on %u shards\n", matches, ticksPerMatch, threads);
+
+    // Spawning reports every wave; hundreds of matches would drown the report
+    SetLogLevel(LOG_LEVEL_WARNING);
+
+    // Same matches on more and more threads; each run starts from fresh worlds
+    if (scaling)
+    {
+        std::printf("\n%8s %14s %8s %10s\n", "threads", "ticks/s", "speedup", "efficiency");
+        double single = 0;
+        for (unsigned count = 1;; count = std::min(count * 2, threads))
+        {
+            double rate = TicksPerSecond(RunShards(tuning, matches, ticksPerMatch, count));
+            if (count == 1)
+                single = rate;
+            std::printf("%8u %14.0f %7.2fx %9.0f%%\n", count, rate, rate / single, 100 * rate / single / count);
+            if (count == threads)
+                break;
+        }
+    }
+
+    std::vector<ShardResult> results = RunShards(tuning, matches, ticksPerMatch, threads);
+    SetLogLevel(LOG_LEVEL_DEBUG);
+
+    std::printf("\n%5s %8s %12s %12s %8s %8s %8s\n", "shard", "matches", "ticks/s", "games ended", "p50 us", "p99 us",
+                "max us");
+    std::vector<unsigned long> latency(LATENCY_BUCKETS);
+    unsigned long ticks = 0;
+    unsigned long games = 0;
+    double seconds = 0;
+    Heatmap heatmap;
+    for (size_t shard = 0; shard < results.size(); ++shard)
+    {
+        const ShardResult &result = results[shard];
+        std::printf("%5zu %8d %12.0f %12lu %8.1f %8.1f %8.1f\n", shard, result.matches, result.ticks / result.seconds,
+                    result.games, Percentile(result.latency, 50), Percentile(result.latency, 99), Slowest(result.latency));
+        for (int bucket = 0; bucket < LATENCY_BUCKETS; ++bucket)
+        {
+            latency[bucket] += result.latency[bucket];
+        }
+        ticks += result.ticks;
+        games += result.games;
+        heatmap.Merge(result.heatmap);
+        seconds = std::max(seconds, result.seconds);
+    }
+
+    std::printf("\n%lu ticks in %.2f s: %.0f ticks/s, %.1f matches at real time (%d Hz)\n", ticks, seconds,
+                ticks / seconds, ticks / seconds / TICK_RATE, TICK_RATE);
+    std::printf("Tick time per match: p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us%s\n",
+                Percentile(latency, 50), Percentile(latency, 90), Percentile(latency, 99), Percentile(latency, 99.9),
+                Slowest(latency), Slowest(latency) >= (LATENCY_BUCKETS - 1) / 10.0 ? "+" : "");
+    std::printf("%lu games ended and restarted\n", games);
+
+    if (!heatmapPrefix.empty())
+    {
+        if (!heatmap.Export(heatmapPrefix))
+        {
+            LOG_ERROR("can't write heatmap", {{"path", heatmapPrefix}});
+            return 1;
+        }
+        std::printf("Heatmaps of every match written to %s.csv and %s-*.pgm\n", heatmapPrefix.c_str(), heatmapPrefix.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,17 @@
+#ifndef MATCH_SERVER_H
+#define MATCH_SERVER_H
+
+#include <string>
+#include "tuning.h"
+
+// Plays many independent headless matches, each its own World driven by a scripted player, as fast as the
+// cores allow. Matches are split into one shard per worker thread; a shard builds, plays and measures its
+// matches on its own thread with its own memory ledger, so shards share nothing while they run. A match
+// that ends starts over with its next seed. Prints aggregate ticks per second and the distribution of
+// per-match tick times; with scaling set, first repeats the run on 1, 2, 4... threads up to threads.
+// Each shard keeps one heatmap for its matches; they are merged and exported when heatmapPrefix is set.
+// Returns the process exit code.
+int RunMatchServer(const Tuning &tuning, int matches, unsigned long ticksPerMatch, unsigned threads, bool scaling,
+                   const std::string &heatmapPrefix); // --server MATCHES
+
+#endif // MATCH_SERVER_H
@@ -0,0 +1,130 @@
+#include "memory.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+
+namespace
+{
+    struct TagCounters
+    {
+        std::atomic<size_t> currentBytes;
+        std::atomic<size_t> peakBytes;
+        std::atomic<size_t> allocations;
+        std::atomic<size_t> frees;
+    };
+
+    // Zero initialised before any dynamic initialisation, so containers in globals can use it too
+    TagCounters counters[MEMORY_TAG_COUNT];
+
+    const char *TAG_NAMES[MEMORY_TAG_COUNT] = {
+        "entities", "projectiles", "effects", "rendering", "ui strings", "assets", "telemetry", "network"};
+
+    thread_local MemoryLedger *ledger = nullptr; // Innermost ledger of this thread
+}
+
+void TrackAllocation(MemoryTag tag, size_t bytes)
+{
+    if (ledger)
+    {
+        ledger->Allocate(tag, bytes);
+        return;
+    }
+
+    TagCounters &tagCounters = counters[tag];
+    size_t current = tagCounters.currentBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    tagCounters.allocations.fetch_add(1, std::memory_order_relaxed);
+
+    size_t peak = tagCounters.peakBytes.load(std::memory_order_relaxed);
+    while (current > peak && !tagCounters.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+    {
+    }
+}
+
+void TrackFree(MemoryTag tag, size_t bytes)
+{
+    if (ledger)
+    {
+        ledger->Free(tag, bytes);
+        return;
+    }
+
+    counters[tag].currentBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    counters[tag].frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+MemoryStats GetMemoryStats(MemoryTag tag)
+{
+    const TagCounters &tagCounters = counters[tag];
+    MemoryStats stats;
+    stats.currentBytes = tagCounters.currentBytes.load(std::memory_order_relaxed);
+    stats.peakBytes = tagCounters.peakBytes.load(std::memory_order_relaxed);
+    stats.allocations = tagCounters.allocations.load(std::memory_order_relaxed);
+    stats.liveAllocations = stats.allocations - tagCounters.frees.load(std::memory_order_relaxed);
+    return stats;
+}
+
+const char *GetMemoryTagName(MemoryTag tag)
+{
+    return TAG_NAMES[tag];
+}
+
+void DumpMemoryStats()
+{
+    printf("Memory by subsystem:\n");
+    printf("  %-12s %12s %12s %12s %8s\n", "subsystem", "current KB", "peak KB", "allocations", "live");
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; ++tag)
+    {
+        MemoryStats stats = GetMemoryStats(static_cast<MemoryTag>(tag));
+        printf("  %-12s %12.1f %12.1f %12zu %8zu\n", TAG_NAMES[tag], stats.currentBytes / 1024.0,
+               stats.peakBytes / 1024.0, stats.allocations, stats.liveAllocations);
+    }
+}
+
+MemoryLedger::MemoryLedger() : previous(ledger), tags()
+{
+    ledger = this;
+}
+
+MemoryLedger::~MemoryLedger()
+{
+    ledger = previous;
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; ++tag)
+    {
+        const Counters &ours = tags[tag];
+        if (previous)
+        {
+            Counters &theirs = previous->tags[tag];
+            theirs.peakBytes = std::max(theirs.peakBytes, theirs.currentBytes + ours.peakBytes);
+            theirs.currentBytes += ours.currentBytes;
+            theirs.allocations += ours.allocations;
+            theirs.frees += ours.frees;
+            continue;
+        }
+
+        // The shared peak is taken as if everything held at the ledger's peak had been allocated on top of now
+        TagCounters &tagCounters = counters[tag];
+        size_t current = tagCounters.currentBytes.fetch_add(static_cast<size_t>(ours.currentBytes), std::memory_order_relaxed);
+        size_t candidate = current + static_cast<size_t>(ours.peakBytes);
+        size_t peak = tagCounters.peakBytes.load(std::memory_order_relaxed);
+        while (candidate > peak && !tagCounters.peakBytes.compare_exchange_weak(peak, candidate, std::memory_order_relaxed))
+        {
+        }
+        tagCounters.allocations.fetch_add(ours.allocations, std::memory_order_relaxed);
+        tagCounters.frees.fetch_add(ours.frees, std::memory_order_relaxed);
+    }
+}
+
+void MemoryLedger::Allocate(MemoryTag tag, size_t bytes)
+{
+    Counters &entry = tags[tag];
+    entry.currentBytes += static_cast<ptrdiff_t>(bytes);
+    entry.peakBytes = std::max(entry.peakBytes, entry.currentBytes);
+    entry.allocations++;
+}
+
+void MemoryLedger::Free(MemoryTag tag, size_t bytes)
+{
+    Counters &entry = tags[tag];
+    entry.currentBytes -= static_cast<ptrdiff_t>(bytes);
+    entry.frees++;
+}
@@ -0,0 +1,108 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <cstddef>
+#include <new>
+#include <string>
+#include <vector>
+
+// Memory accounting. Containers that use TrackingAllocator report their bytes against a subsystem
+// tag; assets that live outside our heap (textures, render targets) are reported by hand.
+enum MemoryTag
+{
+    MEMORY_ENTITIES,    // Archetype storage for players, enemies, bosses, emitters, power-ups, spatial grid
+    MEMORY_PROJECTILES, // Archetype storage for shots, missiles and bombs
+    MEMORY_EFFECTS,     // Background stars
+    MEMORY_RENDERING,   // Draw commands in the render snapshots
+    MEMORY_UI,          // Menu and overlay strings
+    MEMORY_ASSETS,      // Textures and render targets, estimated from their size
+    MEMORY_TELEMETRY,   // Telemetry and log rings and writer buffers
+    MEMORY_NETWORK,     // Spectator frames and socket buffers
+    MEMORY_TAG_COUNT
+};
+
+struct MemoryStats
+{
+    size_t currentBytes;
+    size_t peakBytes;
+    size_t allocations; // Allocations ever made
+    size_t liveAllocations;
+};
+
+void TrackAllocation(MemoryTag tag, size_t bytes);
+void TrackFree(MemoryTag tag, size_t bytes);
+MemoryStats GetMemoryStats(MemoryTag tag);
+const char *GetMemoryTagName(MemoryTag tag);
+void DumpMemoryStats(); // Table of every tag to stdout
+
+// Accounting private to one thread. While a ledger is alive its thread's allocations are counted in it
+// instead of the shared counters, so workers that allocate in parallel never contend on them; the totals
+// are merged into the shared counters when it is destroyed. Ledgers nest.
+class MemoryLedger
+{
+public:
+    MemoryLedger();
+    ~MemoryLedger();
+    MemoryLedger(const MemoryLedger &) = delete;
+    MemoryLedger &operator=(const MemoryLedger &) = delete;
+
+    void Allocate(MemoryTag tag, size_t bytes);
+    void Free(MemoryTag tag, size_t bytes);
+
+private:
+    struct Counters
+    {
+        ptrdiff_t currentBytes; // Net, negative when freeing memory allocated before the ledger
+        ptrdiff_t peakBytes;    // Highest net
+        size_t allocations;
+        size_t frees;
+    };
+
+    MemoryLedger *previous;
+    Counters tags[MEMORY_TAG_COUNT];
+};
+
+// Standard allocator that reports to a tag
+template <typename T, MemoryTag Tag>
+class TrackingAllocator
+{
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef TrackingAllocator<U, Tag> other;
+    };
+
+    TrackingAllocator() {}
+
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U, Tag> &) {}
+
+    T *allocate(size_t count)
+    {
+        T *memory = static_cast<T *>(::operator new(count * sizeof(T)));
+        TrackAllocation(Tag, count * sizeof(T));
+        return memory;
+    }
+
+    void deallocate(T *memory, size_t count)
+    {
+        TrackFree(Tag, count * sizeof(T));
+        ::operator delete(memory);
+    }
+};
+
+template <typename T, typename U, MemoryTag Tag>
+bool operator==(const TrackingAllocator<T, Tag> &, const TrackingAllocator<U, Tag> &) { return true; }
+
+template <typename T, typename U, MemoryTag Tag>
+bool operator!=(const TrackingAllocator<T, Tag> &, const TrackingAllocator<U, Tag> &) { return false; }
+
+template <typename T, MemoryTag Tag>
+using TrackedVector = std::vector<T, TrackingAllocator<T, Tag>>;
+
+typedef std::basic_string<char, std::char_traits<char>, TrackingAllocator<char, MEMORY_UI>> UiString;
+
+#endif // MEMORY_H
@@ -0,0 +1,72 @@
+#include "particles.h"
+#include <cmath>
+
+ParticleEffects::ParticleEffects(size_t capacity) : capacity(capacity)
+{
+    particles.reserve(capacity);
+}
+
+void ParticleEffects::Spawn(const GameEvent &event)
+{
+    switch (event.type)
+    {
+    case EVENT_HIT:
+        Burst(event.x, event.y, 4, 150, 0.15f, 2, WHITE);
+        break;
+    case EVENT_KILL:
+        Burst(event.x, event.y, 16, 220, 0.5f, 3, ORANGE);
+        Burst(event.x, event.y, 8, 120, 0.35f, 4, YELLOW);
+        break;
+    case EVENT_PLAYER_DEATH:
+        Burst(event.x, event.y, 48, 300, 1.0f, 4, RED);
+        Burst(event.x, event.y, 24, 160, 0.8f, 5, ORANGE);
+        break;
+    case EVENT_POWER_UP:
+        Burst(event.x, event.y, 16, 180, 0.4f, 3, GOLD);
+        break;
+    case EVENT_SHOT:
+    case EVENT_GAME_OVER:
+    case EVENT_WAVE_START:
+        break;
+    }
+}
+
+void ParticleEffects::Update(float deltaTime)
+{
+    for (size_t i = particles.size(); i-- > 0;)
+    {
+        Particle &particle = particles[i];
+        particle.life -= deltaTime;
+        if (particle.life <= 0)
+        {
+            particle = particles.back();
+            particles.pop_back();
+            continue;
+        }
+        particle.x += particle.vx * deltaTime;
+        particle.y += particle.vy * deltaTime;
+        particle.vx *= 1 - 2 * deltaTime; // Drag, so bursts slow to a drift before fading
+        particle.vy *= 1 - 2 * deltaTime;
+    }
+}
+
+void ParticleEffects::Draw() const
+{
+    for (const Particle &particle : particles)
+    {
+        float half = particle.size / 2;
+        DrawRectangleV({particle.x - half, particle.y - half}, {particle.size, particle.size},
+                       Fade(particle.color, particle.life / particle.maxLife));
+    }
+}
+
+void ParticleEffects::Burst(float x, float y, int count, float speed, float life, float size, Color color)
+{
+    for (int i = 0; i < count && particles.size() < capacity; ++i)
+    {
+        float angle = random.Range(0, 359) * (3.14159265f / 180);
+        float velocity = speed * random.Range(30, 100) / 100.0f;
+        float lifetime = life * random.Range(60, 100) / 100.0f;
+        particles.push_back({x, y, cosf(angle) * velocity, sinf(angle) * velocity, lifetime, lifetime, size, color});
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <raylib.h>
+#include "events.h"
+#include "random.h"
+
+// Purely visual debris for hits, kills and deaths. Lives on the render thread and never feeds back
+// into the simulation, so it can use frame time and its own random numbers.
+class ParticleEffects
+{
+public:
+    explicit ParticleEffects(size_t capacity = 4096); // Bursts are trimmed rather than growing past this
+    void Spawn(const GameEvent &event);
+    void Update(float deltaTime);
+    void Draw() const;
+    size_t Size() const { return particles.size(); }
+
+private:
+    struct Particle
+    {
+        float x;
+        float y;
+        float vx; // Pixels per second
+        float vy;
+        float life; // Seconds left
+        float maxLife;
+        float size;
+        Color color;
+    };
+
+    size_t capacity;
+    TrackedVector<Particle, MEMORY_EFFECTS> particles;
+    Random random;
+
+    void Burst(float x, float y, int count, float speed, float life, float size, Color color);
+};
+
+#endif // PARTICLES_H
@@ -0,0 +1,36 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// Small deterministic generator (xorshift32) owned by the simulation, so the same seed and inputs
+// replay the same game on every platform, unlike the C library rand() behind GetRandomValue.
+class Random
+{
+public:
+    explicit Random(uint32_t seed = 1) { Seed(seed); }
+
+    void Seed(uint32_t seed)
+    {
+        state = seed ? seed : 0x9E3779B9u; // xorshift must never be all zeros
+    }
+
+    uint32_t Next()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // Random integer in [min, max], like GetRandomValue
+    int Range(int min, int max)
+    {
+        return min + static_cast<int>(Next() % static_cast<uint32_t>(max - min + 1));
+    }
+
+private:
+    uint32_t state;
+};
+
+#endif // RANDOM_H
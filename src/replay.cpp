@@ -0,0 +1,381 @@
+#include "replay.h"
+#include "logger.h"
+#include <algorithm>
+
+namespace
+{
+    const char MAGIC[4] = {'G', 'R', 'P', 'L'};
+    const uint32_t VERSION = 4;
+#ifdef GALAGA_FIXED_POINT
+    const uint32_t SCALAR_FIXED = 1; // Keyframes hold raw Scalars, so they only load into a build of the same kind
+#else
+    const uint32_t SCALAR_FIXED = 0;
+#endif
+
+    enum ChunkType : uint32_t
+    {
+        CHUNK_KEYFRAME, // SaveWorld output for the world as it was before the chunk's tick
+        CHUNK_INPUT,    // One InputButton byte per tick, starting at the chunk's tick
+        CHUNK_TUNING    // Tuning applied before the chunk's tick
+    };
+
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t fixedPoint;
+        int32_t tickRate;
+        int32_t playerWidth;
+        int32_t playerHeight;
+        uint32_t seed;
+    };
+
+    struct ChunkHeader
+    {
+        uint32_t type;
+        uint32_t tick;
+        uint32_t size; // Bytes following the header
+    };
+
+    uint8_t PackInput(const PlayerInput &input)
+    {
+        return (input.left ? INPUT_LEFT : 0) | (input.right ? INPUT_RIGHT : 0) | (input.up ? INPUT_UP : 0) |
+               (input.down ? INPUT_DOWN : 0) | (input.fire ? INPUT_FIRE : 0);
+    }
+
+    PlayerInput UnpackInput(uint8_t bits)
+    {
+        PlayerInput input;
+        input.left = (bits & INPUT_LEFT) != 0;
+        input.right = (bits & INPUT_RIGHT) != 0;
+        input.up = (bits & INPUT_UP) != 0;
+        input.down = (bits & INPUT_DOWN) != 0;
+        input.fire = (bits & INPUT_FIRE) != 0;
+        return input;
+    }
+
+    // "run.grpl" -> "run-3.grpl"
+    std::string NumberedPath(const std::string &path, int number)
+    {
+        if (number <= 1)
+            return path;
+        size_t dot = path.find_last_of('.');
+        size_t slash = path.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            dot = path.size();
+        return path.substr(0, dot) + "-" + std::to_string(number) + path.substr(dot);
+    }
+}
+
+void StateWriter::Write(const BossHull &hull)
+{
+    Write(hull.owner);
+    Write(hull.parts);
+    Write(hull.nodes);
+}
+
+void StateWriter::Append(const void *data, size_t size)
+{
+    const char *bytesIn = static_cast<const char *>(data);
+    bytes.insert(bytes.end(), bytesIn, bytesIn + size);
+}
+
+void StateReader::Read(BossHull &hull)
+{
+    Read(hull.owner);
+    Read(hull.parts);
+    Read(hull.nodes);
+}
+
+bool StateReader::Take(size_t bytes)
+{
+    if (failed || bytes > size - offset)
+    {
+        failed = true;
+        return false;
+    }
+    offset += bytes;
+    return true;
+}
+
+void SaveWorld(const World &world, StateWriter &writer)
+{
+    writer.Write(world.playerWidth);
+    writer.Write(world.playerHeight);
+    world.players.Save(writer);
+    world.enemies.Save(writer);
+    world.playerShots.Save(writer);
+    world.enemyShots.Save(writer);
+    world.bombs.Save(writer);
+    world.missiles.Save(writer);
+    world.powerUps.Save(writer);
+    world.emitters.Save(writer);
+    world.bosses.Save(writer);
+    world.enemyGrid.Save(writer);
+    world.timers.Save(writer);
+    writer.Write(world.kills);
+    writer.Write(world.stars);
+    writer.Write(world.tuning);
+    writer.Write(world.random);
+    writer.Write(world.seed);
+    writer.Write(world.nextWaveSeed);
+    writer.Write(world.score);
+    writer.Write(world.level);
+    writer.Write(world.wave);
+    writer.Write(world.gameOver);
+    writer.Write(world.musicCue);
+    writer.Write(world.tick);
+    writer.Write(world.retired);
+}
+
+bool LoadWorld(World &world, StateReader &reader)
+{
+    reader.Read(world.playerWidth);
+    reader.Read(world.playerHeight);
+    world.players.Load(reader);
+    world.enemies.Load(reader);
+    world.playerShots.Load(reader);
+    world.enemyShots.Load(reader);
+    world.bombs.Load(reader);
+    world.missiles.Load(reader);
+    world.powerUps.Load(reader);
+    world.emitters.Load(reader);
+    world.bosses.Load(reader);
+    world.enemyGrid.Load(reader);
+    world.timers.Load(reader);
+    reader.Read(world.kills);
+    reader.Read(world.stars);
+    reader.Read(world.tuning);
+    reader.Read(world.random);
+    reader.Read(world.seed);
+    reader.Read(world.nextWaveSeed);
+    reader.Read(world.score);
+    reader.Read(world.level);
+    reader.Read(world.wave);
+    reader.Read(world.gameOver);
+    reader.Read(world.musicCue);
+    reader.Read(world.tick);
+    reader.Read(world.retired);
+    return !reader.Failed();
+}
+
+ReplayRecorder::ReplayRecorder(const std::string &path, int tickRate)
+    : path(path), tickRate(tickRate), games(0), file(nullptr), nextTick(0), inputsStart(0)
+{
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+    Close();
+}
+
+void ReplayRecorder::Record(const World &world, const PlayerInput &input)
+{
+    // A tick of 0 or a gap means a new game, which gets its own file
+    if (!file || world.tick != nextTick || world.tick == 0)
+    {
+        Close();
+        Open(world);
+        if (!file)
+            return;
+    }
+    else if ((world.tick - inputsStart) % KEYFRAME_INTERVAL == 0 && !inputs.empty())
+    {
+        FlushInputs();
+        state.Clear();
+        SaveWorld(world, state);
+        WriteChunk(CHUNK_KEYFRAME, static_cast<uint32_t>(world.tick), state.Bytes().data(), state.Bytes().size());
+    }
+
+    if (memcmp(&world.tuning, &recordedTuning, sizeof(Tuning)) != 0)
+    {
+        recordedTuning = world.tuning;
+        WriteChunk(CHUNK_TUNING, static_cast<uint32_t>(world.tick), &recordedTuning, sizeof(Tuning));
+    }
+
+    inputs.push_back(PackInput(input));
+    nextTick = world.tick + 1;
+}
+
+void ReplayRecorder::Close()
+{
+    if (!file)
+        return;
+    FlushInputs();
+    fclose(file);
+    file = nullptr;
+}
+
+void ReplayRecorder::Open(const World &world)
+{
+    std::string gamePath = NumberedPath(path, ++games);
+    file = fopen(gamePath.c_str(), "wb");
+    if (!file)
+    {
+        LOG_ERROR("can't write replay", {{"path", gamePath}});
+        return;
+    }
+
+    FileHeader header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.fixedPoint = SCALAR_FIXED;
+    header.tickRate = tickRate;
+    header.playerWidth = world.playerWidth;
+    header.playerHeight = world.playerHeight;
+    header.seed = world.seed;
+    fwrite(&header, sizeof(header), 1, file);
+
+    inputs.clear();
+    inputsStart = world.tick;
+    recordedTuning = world.tuning;
+    state.Clear();
+    SaveWorld(world, state);
+    WriteChunk(CHUNK_KEYFRAME, static_cast<uint32_t>(world.tick), state.Bytes().data(), state.Bytes().size());
+}
+
+void ReplayRecorder::FlushInputs()
+{
+    if (inputs.empty())
+        return;
+    WriteChunk(CHUNK_INPUT, static_cast<uint32_t>(inputsStart), inputs.data(), inputs.size());
+    inputsStart += inputs.size();
+    inputs.clear();
+}
+
+void ReplayRecorder::WriteChunk(uint32_t type, uint32_t tick, const void *data, size_t size)
+{
+    ChunkHeader chunk = {type, tick, static_cast<uint32_t>(size)};
+    fwrite(&chunk, sizeof(chunk), 1, file);
+    fwrite(data, 1, size, file);
+    fflush(file); // A crash loses at most the inputs since the last keyframe
+}
+
+Replay::Replay() : file(nullptr), tickRate(60), playerWidth(0), playerHeight(0), firstTick(0), restored(false)
+{
+}
+
+Replay::~Replay()
+{
+    if (file)
+        fclose(file);
+}
+
+bool Replay::Open(const std::string &path)
+{
+    file = fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        LOG_ERROR("can't open replay", {{"path", path}});
+        return false;
+    }
+
+    FileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION)
+    {
+        LOG_ERROR("not a replay of this version", {{"path", path}, {"version", VERSION}});
+        return false;
+    }
+    if (header.fixedPoint != SCALAR_FIXED)
+    {
+        LOG_ERROR("replay was recorded by another build", {{"path", path}, {"arithmetic", header.fixedPoint ? "fixed" : "floating"}});
+        return false;
+    }
+    tickRate = header.tickRate;
+    playerWidth = header.playerWidth;
+    playerHeight = header.playerHeight;
+
+    // Index the chunks. A recording cut short by a crash ends at the last complete chunk.
+    ChunkHeader chunk;
+    while (fread(&chunk, sizeof(chunk), 1, file) == 1)
+    {
+        long offset = ftell(file);
+        if (chunk.type == CHUNK_KEYFRAME)
+        {
+            if (keyframes.empty())
+                firstTick = chunk.tick;
+            keyframes.push_back({chunk.tick, offset, chunk.size});
+            if (fseek(file, chunk.size, SEEK_CUR) != 0)
+                break;
+        }
+        else if (chunk.type == CHUNK_INPUT && chunk.tick == firstTick + inputs.size())
+        {
+            size_t start = inputs.size();
+            inputs.resize(start + chunk.size);
+            if (fread(inputs.data() + start, 1, chunk.size, file) != chunk.size)
+            {
+                inputs.resize(start);
+                break;
+            }
+        }
+        else if (chunk.type == CHUNK_TUNING && chunk.size == sizeof(Tuning))
+        {
+            TuningChange change;
+            change.tick = chunk.tick;
+            if (fread(&change.tuning, sizeof(Tuning), 1, file) != 1)
+                break;
+            tuningChanges.push_back(change);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    // Keyframes past the recorded inputs would seek to ticks that can't be played
+    while (!keyframes.empty() && keyframes.back().tick > EndTick())
+    {
+        keyframes.pop_back();
+    }
+    if (keyframes.empty())
+    {
+        LOG_ERROR("replay holds no complete keyframe", {{"path", path}});
+        return false;
+    }
+    return true;
+}
+
+bool Replay::Seek(World &world, unsigned long tick)
+{
+    tick = std::max(FirstTick(), std::min(tick, EndTick()));
+    auto keyframe = std::upper_bound(keyframes.begin(), keyframes.end(), tick,
+                                     [](unsigned long t, const Keyframe &k) { return t < k.tick; }) - 1;
+
+    // Playing on from where the world already is beats reloading whenever no keyframe lies in between
+    bool playOn = restored && world.tick >= keyframe->tick && world.tick <= tick;
+    if (!playOn)
+    {
+        stateBytes.resize(keyframe->size);
+        if (fseek(file, keyframe->offset, SEEK_SET) != 0 ||
+            fread(stateBytes.data(), 1, stateBytes.size(), file) != stateBytes.size())
+            return false;
+        StateReader reader(stateBytes.data(), stateBytes.size());
+        if (!LoadWorld(world, reader))
+            return false;
+        restored = true;
+    }
+
+    while (world.tick < tick)
+    {
+        if (!Step(world))
+            return false;
+    }
+    return true;
+}
+
+bool Replay::Step(World &world)
+{
+    if (world.tick < FirstTick() || world.tick >= EndTick())
+        return false;
+
+    for (const TuningChange &change : tuningChanges)
+    {
+        if (change.tick == world.tick)
+            ApplyTuning(world, change.tuning);
+    }
+
+    unsigned long tick = world.tick;
+    HandleGameplay(world, UnpackInput(inputs[tick - firstTick]), Scalar(1) / Scalar(tickRate));
+    return world.tick != tick; // A game that is already over doesn't advance
+}
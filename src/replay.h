@@ -0,0 +1,196 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "world.h"
+
+// Appends simulation state to a byte buffer. Plain data is copied as is; containers and the few
+// structs that hold containers are written member by member.
+class StateWriter
+{
+public:
+    template <typename T>
+    void Write(const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "StateWriter needs an overload for this type");
+        Append(&value, sizeof(T));
+    }
+
+    template <typename T, MemoryTag Tag>
+    void Write(const TrackedVector<T, Tag> &values)
+    {
+        Write(static_cast<uint32_t>(values.size()));
+        WriteElements(values, std::is_trivially_copyable<T>());
+    }
+
+    void Write(const BossHull &hull);
+
+    const TrackedVector<char, MEMORY_TELEMETRY> &Bytes() const { return bytes; }
+    void Clear() { bytes.clear(); }
+
+private:
+    TrackedVector<char, MEMORY_TELEMETRY> bytes;
+
+    void Append(const void *data, size_t size);
+
+    template <typename T, MemoryTag Tag>
+    void WriteElements(const TrackedVector<T, Tag> &values, std::true_type)
+    {
+        Append(values.data(), values.size() * sizeof(T));
+    }
+
+    template <typename T, MemoryTag Tag>
+    void WriteElements(const TrackedVector<T, Tag> &values, std::false_type)
+    {
+        for (const T &value : values)
+        {
+            Write(value);
+        }
+    }
+};
+
+// Reads back what StateWriter wrote. Running past the end or meeting an impossible count marks the
+// reader as failed and leaves the rest of the state untouched rather than reading garbage.
+class StateReader
+{
+public:
+    StateReader(const char *data, size_t size) : data(data), size(size), offset(0), failed(false) {}
+
+    template <typename T>
+    void Read(T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "StateReader needs an overload for this type");
+        if (Take(sizeof(T)))
+            memcpy(&value, data + offset - sizeof(T), sizeof(T));
+    }
+
+    template <typename T, MemoryTag Tag>
+    void Read(TrackedVector<T, Tag> &values)
+    {
+        uint32_t count = 0;
+        Read(count);
+        if (failed || count > size - offset)
+        {
+            failed = true; // Every element takes at least a byte, so this count can't be real
+            return;
+        }
+        values.clear();
+        values.reserve(count);
+        ReadElements(values, count, std::is_trivially_copyable<T>());
+    }
+
+    void Read(BossHull &hull);
+
+    bool Failed() const { return failed; }
+
+private:
+    const char *data;
+    size_t size;
+    size_t offset;
+    bool failed;
+
+    bool Take(size_t bytes);
+
+    template <typename T, MemoryTag Tag>
+    void ReadElements(TrackedVector<T, Tag> &values, uint32_t count, std::true_type)
+    {
+        // Copied through aligned storage: the buffer has no alignment and some components lack a default constructor
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        for (uint32_t i = 0; i < count && Take(sizeof(T)); ++i)
+        {
+            memcpy(&storage, data + offset - sizeof(T), sizeof(T));
+            values.push_back(*reinterpret_cast<const T *>(&storage));
+        }
+    }
+
+    template <typename T, MemoryTag Tag>
+    void ReadElements(TrackedVector<T, Tag> &values, uint32_t count, std::false_type)
+    {
+        values.resize(count);
+        for (T &value : values)
+        {
+            Read(value);
+        }
+    }
+};
+
+// Everything HandleGameplay reads or writes, so a loaded world continues exactly like the saved one
+void SaveWorld(const World &world, StateWriter &writer);
+bool LoadWorld(World &world, StateReader &reader);
+
+// Writes a replay while a game is played: the input of every tick, a full keyframe of the world every
+// KEYFRAME_INTERVAL ticks, and any tuning reload. One file per game; later games get -2, -3... suffixes.
+class ReplayRecorder
+{
+public:
+    static const unsigned long KEYFRAME_INTERVAL = 600;
+
+    ReplayRecorder(const std::string &path, int tickRate);
+    ~ReplayRecorder();
+    void Record(const World &world, const PlayerInput &input); // Call right before HandleGameplay
+    void Close();
+
+private:
+    std::string path;
+    int tickRate;
+    int games;
+    FILE *file;
+    unsigned long nextTick; // Tick the next Record call is expected at
+    Tuning recordedTuning;
+    TrackedVector<uint8_t, MEMORY_TELEMETRY> inputs; // Not yet written, starting at inputsStart
+    unsigned long inputsStart;
+    StateWriter state;
+
+    void Open(const World &world);
+    void FlushInputs();
+    void WriteChunk(uint32_t type, uint32_t tick, const void *data, size_t size);
+};
+
+// A replay file opened for viewing. Inputs and tuning changes are loaded up front; keyframes are only
+// indexed, and read from disk when a seek needs one.
+class Replay
+{
+public:
+    Replay();
+    ~Replay();
+    bool Open(const std::string &path);
+    unsigned long FirstTick() const { return firstTick; }
+    unsigned long EndTick() const { return firstTick + inputs.size(); } // One past the last recorded tick
+    int TickRate() const { return tickRate; }
+    int PlayerWidth() const { return playerWidth; }
+    int PlayerHeight() const { return playerHeight; }
+    // Restores the nearest keyframe at or before tick, then simulates up to it. Seeking forward within
+    // the same keyframe interval just plays on. The world must only be advanced by this replay.
+    bool Seek(World &world, unsigned long tick);
+    bool Step(World &world); // Plays one recorded tick; false at the end of the recording
+
+private:
+    struct Keyframe
+    {
+        unsigned long tick;
+        long offset; // File position of the state bytes
+        uint32_t size;
+    };
+
+    struct TuningChange
+    {
+        unsigned long tick;
+        Tuning tuning;
+    };
+
+    FILE *file;
+    int tickRate;
+    int playerWidth;
+    int playerHeight;
+    unsigned long firstTick; // Tick of the first keyframe
+    bool restored;           // A keyframe has been loaded, so the world's tick says where playback is
+    TrackedVector<uint8_t, MEMORY_TELEMETRY> inputs; // Indexed from firstTick by the tick that consumed the input
+    TrackedVector<Keyframe, MEMORY_TELEMETRY> keyframes;
+    TrackedVector<TuningChange, MEMORY_TELEMETRY> tuningChanges;
+    TrackedVector<char, MEMORY_TELEMETRY> stateBytes;
+};
+
+#endif // REPLAY_H
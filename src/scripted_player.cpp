@@ -0,0 +1,144 @@
+#include "scripted_player.h"
+#include <cmath>
+
+namespace
+{
+    const int TICK_RATE = 60; // The lookahead assumes the default tick rate
+
+    // Ticks ahead the scripted player checks, dense near term where a miss is fatal
+    const int LOOKAHEAD_TICKS[] = {1, 2, 3, 4, 6, 8, 11, 15, 20, 27, 36};
+    const float LOOKAHEAD = 36.0f / TICK_RATE;
+
+    // Enemies have no Velocity; this is what EnemyBehaviourSystem will do with them in the next moment
+    Velocity EstimateEnemyVelocity(const EnemyBrain &brain)
+    {
+        float speed = ToFloat(brain.speed);
+        float time = ToFloat(brain.movementPatternTime);
+        switch (brain.state)
+        {
+        case ENTERING:
+            return {0, Scalar(speed * 60)};
+        case ATTACKING:
+            return {Scalar(std::cos(time * 2) * speed * 100), Scalar(speed * 40)};
+        default:
+            return {0, 0};
+        }
+    }
+
+    // The player as the threat filter sees it
+    struct Reach
+    {
+        float playerX;
+        float playerY;
+        float halfWidth;
+        float halfHeight;
+        float travel; // How far the player can move within the lookahead
+    };
+
+    // Keeps only what could touch the player within the lookahead, so the per-direction checks
+    // walk a handful of threats rather than every bullet on screen
+    void AddThreat(const Position &position, const Velocity &velocity, const Body &body, const Reach &reach,
+                   std::vector<ScriptedThreat> &threats)
+    {
+        ScriptedThreat threat = {ToFloat(position.x), ToFloat(position.y), ToFloat(velocity.x), ToFloat(velocity.y),
+                         reach.halfWidth + ToFloat(body.width) / 2 + 4, reach.halfHeight + ToFloat(body.height) / 2 + 4};
+        float rangeX = threat.reachX + std::fabs(threat.velocityX) * LOOKAHEAD + reach.travel;
+        float rangeY = threat.reachY + std::fabs(threat.velocityY) * LOOKAHEAD + reach.travel;
+        if (std::fabs(threat.x - reach.playerX) < rangeX && std::fabs(threat.y - reach.playerY) < rangeY)
+            threats.push_back(threat);
+    }
+
+    template <typename A>
+    void AddProjectileThreats(const A &projectiles, const Reach &reach, std::vector<ScriptedThreat> &threats)
+    {
+        const auto &positions = projectiles.template Column<Position>();
+        const auto &velocities = projectiles.template Column<Velocity>();
+        const auto &bodies = projectiles.template Column<Body>();
+        for (size_t i = 0; i < projectiles.Size(); ++i)
+        {
+            AddThreat(positions[i], velocities[i], bodies[i], reach, threats);
+        }
+    }
+
+    // Seconds until a threat hits the player if it holds this direction, LOOKAHEAD if none does.
+    // Everything is extrapolated along its current velocity.
+    float TimeToImpact(const std::vector<ScriptedThreat> &threats, float playerX, float playerY, float speed, float halfWidth,
+                       int moveX, int moveY)
+    {
+        for (int ticks : LOOKAHEAD_TICKS)
+        {
+            float time = static_cast<float>(ticks) / TICK_RATE;
+            float x = Clamp(playerX + moveX * speed * time, halfWidth, VIRTUAL_WIDTH - halfWidth);
+            float y = Clamp(playerY + moveY * speed * time, 0.0f, float(VIRTUAL_HEIGHT));
+            for (const ScriptedThreat &threat : threats)
+            {
+                if (std::fabs(threat.x + threat.velocityX * time - x) < threat.reachX &&
+                    std::fabs(threat.y + threat.velocityY * time - y) < threat.reachY)
+                    return time;
+            }
+        }
+        return LOOKAHEAD;
+    }
+}
+
+PlayerInput ScriptedPlayer::Decide(const World &world)
+{
+    const Position &player = world.players.Column<Position>()[0];
+    float playerX = ToFloat(player.x);
+    float playerY = ToFloat(player.y);
+
+    float targetX = playerX;
+    float bestDistance = 1e9f;
+    const auto &enemyPositions = world.enemies.Column<Position>();
+    for (const Position &enemy : enemyPositions)
+    {
+        float distance = std::fabs(ToFloat(enemy.x) - playerX);
+        if (enemy.y > 0 && distance < bestDistance)
+        {
+            bestDistance = distance;
+            targetX = ToFloat(enemy.x);
+        }
+    }
+    float homeY = VIRTUAL_HEIGHT * 0.9f;
+
+    float speed = ToFloat(world.players.Column<Pilot>()[0].movementSpeed) * 60;
+    const Body &body = world.players.Column<Body>()[0];
+    Reach reach = {playerX, playerY, ToFloat(body.width) / 2, ToFloat(body.height) / 2, speed * LOOKAHEAD};
+    threats.clear();
+    AddProjectileThreats(world.enemyShots, reach, threats);
+    AddProjectileThreats(world.bombs, reach, threats);
+    const auto &enemyBodies = world.enemies.Column<Body>();
+    const auto &brains = world.enemies.Column<EnemyBrain>();
+    for (size_t i = 0; i < world.enemies.Size(); ++i)
+    {
+        AddThreat(enemyPositions[i], EstimateEnemyVelocity(brains[i]), enemyBodies[i], reach, threats);
+    }
+
+    int bestX = 0;
+    int bestY = 0;
+    float bestTime = -1;
+    float bestCost = 0;
+    for (int moveY = -1; moveY <= 1; ++moveY)
+    {
+        for (int moveX = -1; moveX <= 1; ++moveX)
+        {
+            float time = TimeToImpact(threats, playerX, playerY, speed, reach.halfWidth, moveX, moveY);
+            float cost = std::fabs(playerX + moveX * 60 - targetX) + std::fabs(playerY + moveY * 60 - homeY);
+            if (time > bestTime || (time == bestTime && cost < bestCost))
+            {
+                bestX = moveX;
+                bestY = moveY;
+                bestTime = time;
+                bestCost = cost;
+            }
+        }
+    }
+
+    PlayerInput input = {};
+    input.left = bestX < 0;
+    input.right = bestX > 0;
+    input.up = bestY < 0;
+    input.down = bestY > 0;
+    input.fire = world.tick % 2 == 0; // Fire is a press, so release in between
+    return input;
+}
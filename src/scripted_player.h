@@ -0,0 +1,30 @@
+#ifndef SCRIPTED_PLAYER_H
+#define SCRIPTED_PLAYER_H
+
+#include <vector>
+#include "world.h"
+
+// Something that could hit the player, in plain floats; reach is its half size plus the player's
+struct ScriptedThreat
+{
+    float x;
+    float y;
+    float velocityX;
+    float velocityY;
+    float reachX;
+    float reachY;
+};
+
+// Headless player for the difficulty tuner and the match server. Picks the direction that stays clear
+// longest; among safe ones, lines up under the nearest enemy while keeping low on the screen. Fires as
+// fast as the weapon allows.
+class ScriptedPlayer
+{
+public:
+    PlayerInput Decide(const World &world);
+
+private:
+    std::vector<ScriptedThreat> threats; // Reused every tick
+};
+
+#endif // SCRIPTED_PLAYER_H
@@ -0,0 +1,187 @@
+#include "simulation.h"
+#include <chrono>
+
+SimulationThread::SimulationThread(World &world, int tickRate)
+    : world(world), tickRate(tickRate), pauseRequested(true), idle(false), quit(false), heldKeys(0), submittedKeys(0),
+      tuningSource(nullptr), recorder(nullptr), eventBus(nullptr), spectators(nullptr)
+{
+}
+
+SimulationThread::~SimulationThread()
+{
+    Stop();
+}
+
+void SimulationThread::Start()
+{
+    thread = std::thread(&SimulationThread::Run, this);
+    Pause();
+    Republish();
+}
+
+void SimulationThread::Stop()
+{
+    if (!thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+        pauseRequested = true; // Sends a running thread into the wait below, where it sees quit
+    }
+    stateChanged.notify_all();
+    thread.join();
+}
+
+void SimulationThread::Pause()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    pauseRequested = true;
+    stateChanged.wait(lock, [this] { return idle; });
+}
+
+void SimulationThread::Resume()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pauseRequested = false;
+    }
+    stateChanged.notify_all();
+}
+
+void SimulationThread::Republish()
+{
+    RenderSnapshot &snapshot = snapshots.WriteBuffer();
+    BuildSnapshot(world, snapshot);
+    snapshot.inputTime = 0;
+    if (spectators)
+        spectators->Publish(snapshot);
+    snapshots.Publish();
+}
+
+void SimulationThread::SubmitInput(const PlayerInput &input)
+{
+    InputSample sample;
+    sample.held = (input.left ? INPUT_LEFT : 0) | (input.right ? INPUT_RIGHT : 0) |
+                  (input.up ? INPUT_UP : 0) | (input.down ? INPUT_DOWN : 0);
+    sample.firePressed = input.fire;
+    sample.time = InputClockNow();
+    SubmitInput(sample);
+}
+
+void SimulationThread::SubmitInput(const InputSample &sample)
+{
+    heldKeys.store(sample.held, std::memory_order_relaxed);
+    if (sample.firePressed || sample.held != submittedKeys)
+    {
+        // Queue the change so a tick that runs between two samples can't miss a press, and knows when it happened.
+        // A full queue (only possible while paused) loses the timestamp, never the held state.
+        inputEvents.Push(sample);
+    }
+    submittedKeys = sample.held;
+}
+
+void SimulationThread::SetTuningSource(TuningWatcher *watcher)
+{
+    tuningSource = watcher;
+}
+
+void SimulationThread::SetReplayRecorder(ReplayRecorder *recorder)
+{
+    this->recorder = recorder;
+}
+
+void SimulationThread::SetEventBus(EventBus *bus)
+{
+    eventBus = bus;
+}
+
+void SimulationThread::SetSpectatorServer(SpectatorServer *server)
+{
+    spectators = server;
+}
+
+const RenderSnapshot &SimulationThread::AcquireSnapshot()
+{
+    return snapshots.ReadBuffer();
+}
+
+PlayerInput SimulationThread::TakeInput(int64_t &inputTime)
+{
+    unsigned pressed = 0;
+    inputTime = 0;
+    InputSample sample;
+    while (inputEvents.Pop(sample))
+    {
+        if (sample.firePressed)
+            pressed |= INPUT_FIRE;
+        if (inputTime == 0)
+            inputTime = sample.time;
+    }
+    unsigned held = heldKeys.load(std::memory_order_relaxed);
+
+    PlayerInput input;
+    input.left = (held & INPUT_LEFT) != 0;
+    input.right = (held & INPUT_RIGHT) != 0;
+    input.up = (held & INPUT_UP) != 0;
+    input.down = (held & INPUT_DOWN) != 0;
+    input.fire = (pressed & INPUT_FIRE) != 0;
+    return input;
+}
+
+void SimulationThread::Run()
+{
+    typedef std::chrono::steady_clock Clock;
+    const Clock::duration tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / tickRate));
+    const Scalar deltaTime = Scalar(1) / Scalar(tickRate);
+    Clock::time_point nextTick = Clock::now();
+
+    while (true)
+    {
+        if (pauseRequested.load())
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            idle = true;
+            stateChanged.notify_all();
+            stateChanged.wait(lock, [this] { return !pauseRequested || quit; });
+            idle = false;
+            if (quit)
+                break;
+
+            // Drop input that arrived while paused, then restart the tick clock
+            InputSample stale;
+            while (inputEvents.Pop(stale))
+            {
+            }
+            nextTick = Clock::now();
+        }
+
+        // Reloaded tuning takes effect between ticks, never halfway through one
+        Tuning tuning;
+        if (tuningSource && tuningSource->Poll(tuning))
+            ApplyTuning(world, tuning);
+
+        int64_t inputTime;
+        PlayerInput input = TakeInput(inputTime);
+        if (recorder && !world.gameOver)
+            recorder->Record(world, input);
+        HandleGameplay(world, input, deltaTime);
+        if (eventBus)
+            eventBus->Publish(world.events, static_cast<uint32_t>(world.tick));
+        RenderSnapshot &snapshot = snapshots.WriteBuffer();
+        BuildSnapshot(world, snapshot);
+        snapshot.inputTime = inputTime;
+        if (spectators)
+            spectators->Publish(snapshot);
+        snapshots.Publish();
+
+        // Fixed tick rate; if we fell far behind, resynchronise rather than bursting to catch up
+        nextTick += tickDuration;
+        Clock::time_point now = Clock::now();
+        if (now - nextTick > tickDuration * 4)
+        {
+            nextTick = now;
+        }
+        std::this_thread::sleep_until(nextTick);
+    }
+}
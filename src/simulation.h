@@ -0,0 +1,58 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "events.h"
+#include "replay.h"
+#include "spectator.h"
+#include "spsc_ring.h"
+#include "tuning.h"
+#include "world.h"
+#include "triple_buffer.h"
+
+// Runs HandleGameplay at a fixed tick rate on its own thread and publishes a RenderSnapshot after every tick.
+// The render thread feeds input in and draws whatever snapshot is newest, so neither side waits on the other.
+class SimulationThread
+{
+public:
+    SimulationThread(World &world, int tickRate);
+    ~SimulationThread();
+    void Start();   // Spawn the thread, paused
+    void Stop();    // Join the thread
+    void Pause();   // Blocks until the thread is idle, after which the world may be touched directly
+    void Resume();
+    void Republish(); // Publish the world as it is now, only valid while paused
+    void SubmitInput(const PlayerInput &input);  // Timestamps the controls as of now
+    void SubmitInput(const InputSample &sample); // Only one thread may submit input at a time
+    void SetTuningSource(TuningWatcher *watcher); // Polled before every tick; call before Start
+    void SetReplayRecorder(ReplayRecorder *recorder); // Sees every tick's input; call before Start
+    void SetEventBus(EventBus *bus); // Gets every tick's events once the tick is done; call before Start
+    void SetSpectatorServer(SpectatorServer *server); // Broadcasts every published snapshot; call before Start
+    const RenderSnapshot &AcquireSnapshot(); // Newest snapshot, valid until the next call
+
+private:
+    World &world;
+    int tickRate;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable stateChanged;
+    std::atomic<bool> pauseRequested;
+    bool idle;
+    bool quit;
+    std::atomic<unsigned> heldKeys; // Directions currently held
+    unsigned submittedKeys;         // Held bits of the last submitted sample, only the submitting thread touches it
+    SpscRing<InputSample, 256> inputEvents; // Samples that pressed fire or changed what is held, not yet consumed by a tick
+    TripleBuffer<RenderSnapshot> snapshots;
+    TuningWatcher *tuningSource;
+    ReplayRecorder *recorder;
+    EventBus *eventBus;
+    SpectatorServer *spectators;
+
+    void Run();
+    PlayerInput TakeInput(int64_t &inputTime); // inputTime is the earliest consumed sample's time, 0 if none
+};
+
+#endif // SIMULATION_H
@@ -0,0 +1,77 @@
+#include "snapshot.h"
+#include "components.h"
+
+RenderSnapshot::RenderSnapshot()
+    : score(0), lives(0), level(0), wave(0), weaponMode(WEAPON_NORMAL), weaponTime(0), gameOver(false), musicCue(0), tick(0), inputTime(0)
+{
+}
+
+void RenderSnapshot::Clear()
+{
+    commands.clear(); // Keeps capacity, so steady state snapshots don't allocate
+    entities = EntityCounts();
+}
+
+void RenderSnapshot::AddPixel(float x, float y, Color color)
+{
+    commands.push_back({SHAPE_PIXEL, x, y, 1, 1, color, nullptr});
+}
+
+void RenderSnapshot::AddRectangle(float x, float y, float width, float height, Color color)
+{
+    commands.push_back({SHAPE_RECTANGLE, x, y, width, height, color, nullptr});
+}
+
+void RenderSnapshot::AddCircle(float x, float y, float radius, Color color)
+{
+    commands.push_back({SHAPE_CIRCLE, x, y, radius, radius, color, nullptr});
+}
+
+void RenderSnapshot::AddSprite(float x, float y, float width, float height)
+{
+    commands.push_back({SHAPE_SPRITE, x, y, width, height, WHITE, nullptr});
+}
+
+void RenderSnapshot::AddText(const char *text, float x, float y, int fontSize, Color color)
+{
+    commands.push_back({SHAPE_TEXT, x, y, 0, static_cast<float>(fontSize), color, text});
+}
+
+void DrawSnapshot(const RenderSnapshot &snapshot, Texture2D playerTexture)
+{
+    for (const auto &command : snapshot.commands)
+    {
+        switch (command.shape)
+        {
+        case SHAPE_PIXEL:
+            DrawPixel(static_cast<int>(command.x), static_cast<int>(command.y), command.color);
+            break;
+        case SHAPE_RECTANGLE:
+            DrawRectangle(static_cast<int>(command.x), static_cast<int>(command.y),
+                          static_cast<int>(command.width), static_cast<int>(command.height), command.color);
+            break;
+        case SHAPE_CIRCLE:
+            DrawCircle(static_cast<int>(command.x), static_cast<int>(command.y), command.width, command.color);
+            break;
+        case SHAPE_SPRITE:
+            DrawTexturePro(playerTexture, {0, 0, (float)playerTexture.width, (float)playerTexture.height},
+                           {command.x, command.y, command.width, command.height}, {0, 0}, 0.0f, command.color);
+            break;
+        case SHAPE_TEXT:
+            DrawText(command.text, static_cast<int>(command.x), static_cast<int>(command.y),
+                     static_cast<int>(command.height), command.color);
+            break;
+        }
+    }
+
+    // Draw HUD (score, lives, level, wave)
+    DrawText(TextFormat("Score: %06i", snapshot.score), 10, 10, 20, WHITE);
+    DrawText(TextFormat("Lives: %i", snapshot.lives), 10, 40, 20, WHITE);
+    DrawText(TextFormat("Level: %i", snapshot.level), 10, 70, 20, WHITE);
+    DrawText(TextFormat("Wave: %i/%i", snapshot.wave, snapshot.level + 2), 10, 100, 20, WHITE);
+    if (snapshot.weaponMode != WEAPON_NORMAL)
+    {
+        const char *weapon = snapshot.weaponMode == WEAPON_SPREAD ? "Spread" : "Homing";
+        DrawText(TextFormat("%s: %is", weapon, static_cast<int>(snapshot.weaponTime + 0.99f)), 10, 130, 20, GOLD);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <raylib.h>
+#include <cstdint>
+#include "memory.h"
+
+enum DrawShape
+{
+    SHAPE_PIXEL,
+    SHAPE_RECTANGLE,
+    SHAPE_CIRCLE, // width holds the radius
+    SHAPE_SPRITE, // Player texture stretched over the rectangle
+    SHAPE_TEXT    // height holds the font size
+};
+
+struct DrawCommand
+{
+    DrawShape shape;
+    float x;
+    float y;
+    float width;
+    float height;
+    Color color;
+    const char *text; // Only for SHAPE_TEXT, must point at a string literal
+};
+
+// Entity bookkeeping for the debug overlay
+struct EntityCounts
+{
+    int live;     // Entities that can be drawn: players, enemies, projectiles and power-ups
+    int sleeping; // Enemies still flying in above the screen
+    int drawn;    // Entities inside the viewport
+    int retired;  // Entities that left play or ran out of time during the tick
+};
+
+// Immutable picture of one simulation tick, handed from the simulation thread to the render thread
+struct RenderSnapshot
+{
+    TrackedVector<DrawCommand, MEMORY_RENDERING> commands;
+    int score;
+    int lives;
+    int level;
+    int wave;
+    int weaponMode;   // WeaponMode of the player, WEAPON_NORMAL when no power-up is active
+    float weaponTime; // Seconds left on the power-up
+    bool gameOver;
+    int musicCue;       // Changes whenever the level start music should play
+    unsigned long tick; // Simulation tick this snapshot was taken at
+    int64_t inputTime;  // InputClockNow() of the earliest input this tick consumed, 0 if none; for latency measurement
+    EntityCounts entities;
+
+    RenderSnapshot();
+    void Clear();
+    void AddPixel(float x, float y, Color color);
+    void AddRectangle(float x, float y, float width, float height, Color color);
+    void AddCircle(float x, float y, float radius, Color color);
+    void AddSprite(float x, float y, float width, float height);
+    void AddText(const char *text, float x, float y, int fontSize, Color color);
+};
+
+// Replays the snapshot's draw commands and HUD
+void DrawSnapshot(const RenderSnapshot &snapshot, Texture2D playerTexture);
+
+#endif // SNAPSHOT_H
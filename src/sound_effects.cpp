@@ -0,0 +1,113 @@
+#include "sound_effects.h"
+#include "random.h"
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    const unsigned SAMPLE_RATE = 22050;
+    const float TWO_PI = 6.2831853f;
+
+    // Renders seconds of mono 16-bit audio from sample(t, progress), where progress runs 0..1
+    template <typename Fn>
+    Sound Synthesize(float seconds, Fn sample)
+    {
+        std::vector<short> samples(static_cast<size_t>(seconds * SAMPLE_RATE));
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            float t = static_cast<float>(i) / SAMPLE_RATE;
+            float value = sample(t, t / seconds);
+            samples[i] = static_cast<short>(fmaxf(-1.0f, fminf(1.0f, value)) * 32767);
+        }
+        Wave wave = {static_cast<unsigned int>(samples.size()), SAMPLE_RATE, 16, 1, samples.data()};
+        return LoadSoundFromWave(wave); // Copies the samples
+    }
+
+    float Square(float phase)
+    {
+        return phase - floorf(phase) < 0.5f ? 1.0f : -1.0f;
+    }
+
+    // Noise burst, low-passed by smoothing so lower cutoffs sound heavier
+    Sound NoiseBurst(float seconds, float smoothing, uint32_t seed)
+    {
+        Random random(seed);
+        float filtered = 0;
+        return Synthesize(seconds, [&](float, float progress)
+                          {
+            float noise = random.Range(-1000, 1000) / 1000.0f;
+            filtered += (noise - filtered) * smoothing;
+            float envelope = (1 - progress) * (1 - progress);
+            return filtered * envelope * 2; });
+    }
+}
+
+SoundEffects::SoundEffects() : loaded(false), shot(), hit(), explosion(), death(), powerUp()
+{
+}
+
+void SoundEffects::Load()
+{
+    // Falling chirp
+    float phase = 0;
+    shot = Synthesize(0.06f, [&](float, float progress)
+                      {
+        phase += (1200 - 600 * progress) / SAMPLE_RATE;
+        return Square(phase) * 0.3f * (1 - progress); });
+    hit = Synthesize(0.04f, [](float t, float progress)
+                     { return Square(t * 1600) * 0.25f * (1 - progress); });
+    explosion = NoiseBurst(0.3f, 0.3f, 1);
+    death = NoiseBurst(0.8f, 0.08f, 2);
+    // Rising sweep
+    phase = 0;
+    powerUp = Synthesize(0.25f, [&](float, float progress)
+                         {
+        phase += (400 + 800 * progress) / SAMPLE_RATE;
+        return sinf(phase * TWO_PI) * 0.4f; });
+
+    SetSoundVolume(shot, 0.25f);
+    SetSoundVolume(hit, 0.25f);
+    SetSoundVolume(explosion, 0.5f);
+    SetSoundVolume(death, 0.7f);
+    SetSoundVolume(powerUp, 0.5f);
+    loaded = true;
+}
+
+void SoundEffects::Unload()
+{
+    if (!loaded)
+        return;
+    UnloadSound(shot);
+    UnloadSound(hit);
+    UnloadSound(explosion);
+    UnloadSound(death);
+    UnloadSound(powerUp);
+    loaded = false;
+}
+
+void SoundEffects::Play(const GameEvent &event)
+{
+    if (!loaded)
+        return;
+    switch (event.type)
+    {
+    case EVENT_SHOT:
+        PlaySound(shot);
+        break;
+    case EVENT_HIT:
+        PlaySound(hit);
+        break;
+    case EVENT_KILL:
+        PlaySound(explosion);
+        break;
+    case EVENT_PLAYER_DEATH:
+        PlaySound(death);
+        break;
+    case EVENT_POWER_UP:
+        PlaySound(powerUp);
+        break;
+    case EVENT_GAME_OVER:
+    case EVENT_WAVE_START: // The level start music covers new levels
+        break;
+    }
+}
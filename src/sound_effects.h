@@ -0,0 +1,26 @@
+#ifndef SOUND_EFFECTS_H
+#define SOUND_EFFECTS_H
+
+#include <raylib.h>
+#include "events.h"
+
+// Short synthesised sounds for gameplay events, so they need no audio assets.
+// Fed from the audio subscription of the event bus on the render thread.
+class SoundEffects
+{
+public:
+    SoundEffects();
+    void Load();   // After InitAudioDevice
+    void Unload(); // Before CloseAudioDevice
+    void Play(const GameEvent &event);
+
+private:
+    bool loaded;
+    Sound shot;
+    Sound hit;
+    Sound explosion;
+    Sound death;
+    Sound powerUp;
+};
+
+#endif // SOUND_EFFECTS_H
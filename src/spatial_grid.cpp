@@ -0,0 +1,139 @@
+#include "spatial_grid.h"
+
+SpatialGrid::SpatialGrid(int minX, int minY, int width, int height, int cellSize)
+    : minX(minX), minY(minY), columns((width + cellSize - 1) / cellSize), rows((height + cellSize - 1) / cellSize),
+      cellSize(cellSize), stamp(0), cells(columns * rows)
+{
+}
+
+void SpatialGrid::Clear()
+{
+    for (auto &cell : cells)
+        cell.clear();
+    for (auto &tracked : tracking)
+        tracked.cell = -1;
+    trackedIndices.clear();
+}
+
+void SpatialGrid::CellCoords(Scalar x, Scalar y, int &column, int &row) const
+{
+    column = Clamp((static_cast<int>(ToFloat(x)) - minX) / cellSize, 0, columns - 1);
+    row = Clamp((static_cast<int>(ToFloat(y)) - minY) / cellSize, 0, rows - 1);
+}
+
+void SpatialGrid::Place(Entity entity, const Position &position)
+{
+    if (entity.index >= tracking.size())
+    {
+        tracking.resize(entity.index + 1, Tracked{NO_ENTITY, -1, 0, 0});
+    }
+
+    int column, row;
+    CellCoords(position.x, position.y, column, row);
+    int cell = row * columns + column;
+
+    Tracked &tracked = tracking[entity.index];
+    if (tracked.cell >= 0 && tracked.entity == entity && tracked.cell == cell)
+    {
+        // Same cell as last tick, just refresh the cached position
+        cells[cell][tracked.slot].position = position;
+    }
+    else
+    {
+        if (tracked.cell >= 0)
+            RemoveFromCell(tracked);
+        else
+            trackedIndices.push_back(entity.index);
+
+        tracked.entity = entity;
+        tracked.cell = cell;
+        tracked.slot = static_cast<uint32_t>(cells[cell].size());
+        cells[cell].push_back({entity, position});
+    }
+    tracked.stamp = stamp;
+}
+
+void SpatialGrid::RemoveFromCell(Tracked &tracked)
+{
+    auto &items = cells[tracked.cell];
+    items[tracked.slot] = items.back();
+    tracking[items[tracked.slot].entity.index].slot = tracked.slot;
+    items.pop_back();
+}
+
+void SpatialGrid::DropStale()
+{
+    for (size_t i = trackedIndices.size(); i-- > 0;)
+    {
+        Tracked &tracked = tracking[trackedIndices[i]];
+        if (tracked.stamp == stamp)
+            continue;
+
+        RemoveFromCell(tracked);
+        tracked.cell = -1;
+        trackedIndices[i] = trackedIndices.back();
+        trackedIndices.pop_back();
+    }
+}
+
+bool SpatialGrid::FindNearest(Scalar x, Scalar y, Entity &nearest, Position &nearestPosition) const
+{
+    if (trackedIndices.empty())
+        return false;
+
+    int centerColumn, centerRow;
+    CellCoords(x, y, centerColumn, centerRow);
+
+    bool found = false;
+    auto bestDistance = LengthSquared(Scalar(0), Scalar(0));
+    int maxRing = Max(Max(centerColumn, columns - 1 - centerColumn), Max(centerRow, rows - 1 - centerRow));
+
+    // Search rings of cells outwards from the query cell
+    for (int ring = 0; ring <= maxRing; ++ring)
+    {
+        for (int row = centerRow - ring; row <= centerRow + ring; ++row)
+        {
+            if (row < 0 || row >= rows)
+                continue;
+
+            // Inner rows of the ring only contribute their two end cells
+            bool edgeRow = (row == centerRow - ring || row == centerRow + ring);
+            int step = edgeRow ? 1 : Max(1, ring * 2);
+            for (int column = centerColumn - ring; column <= centerColumn + ring; column += step)
+            {
+                if (column < 0 || column >= columns)
+                    continue;
+
+                for (const Item &item : cells[row * columns + column])
+                {
+                    auto distance = LengthSquared(item.position.x - x, item.position.y - y);
+                    if (!found || distance < bestDistance)
+                    {
+                        found = true;
+                        bestDistance = distance;
+                        nearest = item.entity;
+                        nearestPosition = item.position;
+                    }
+                }
+            }
+        }
+
+        // Anything not searched yet lies outside the block of cells covered so far, so once the best
+        // match is closer than the block's nearest open edge it can't be beaten
+        if (found)
+        {
+            Scalar reach = Scalar(1 << 14);
+            if (centerColumn - ring > 0)
+                reach = Min(reach, x - Scalar(minX + (centerColumn - ring) * cellSize));
+            if (centerColumn + ring < columns - 1)
+                reach = Min(reach, Scalar(minX + (centerColumn + ring + 1) * cellSize) - x);
+            if (centerRow - ring > 0)
+                reach = Min(reach, y - Scalar(minY + (centerRow - ring) * cellSize));
+            if (centerRow + ring < rows - 1)
+                reach = Min(reach, Scalar(minY + (centerRow + ring + 1) * cellSize) - y);
+            if (reach >= 0 && bestDistance <= LengthSquared(reach, Scalar(0)))
+                break;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,110 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "components.h"
+
+// Uniform grid over the play field answering nearest-entity and box queries.
+// Sync() updates it incrementally: entities only change buckets when they cross a cell boundary,
+// so the per-tick cost is one pass over positions rather than a rebuild.
+class SpatialGrid
+{
+public:
+    SpatialGrid(int minX, int minY, int width, int height, int cellSize);
+
+    // Bring the grid up to date with every entity in the archetype; entities that are gone get dropped
+    template <typename A>
+    void Sync(const A &archetype)
+    {
+        Sync(archetype, [](size_t) { return true; });
+    }
+
+    // Same, but only rows the filter accepts are kept in the grid
+    template <typename A, typename Filter>
+    void Sync(const A &archetype, Filter include)
+    {
+        stamp++;
+        const auto &positions = archetype.template Column<Position>();
+        for (size_t row = 0; row < positions.size(); ++row)
+        {
+            if (include(row))
+                Place(archetype.GetEntity(row), positions[row]);
+        }
+        DropStale();
+    }
+
+    void Clear();
+
+    // Nearest entity to (x, y); false if the grid is empty
+    bool FindNearest(Scalar x, Scalar y, Entity &nearest, Position &nearestPosition) const;
+
+    // Calls fn(entity) for every entity whose cell touches the box; callers still do the exact test
+    template <typename Fn>
+    void ForEachNear(const Box &box, Fn fn) const
+    {
+        int minColumn, minRow, maxColumn, maxRow;
+        CellCoords(box.x, box.y, minColumn, minRow);
+        CellCoords(box.x + box.width, box.y + box.height, maxColumn, maxRow);
+        for (int row = minRow; row <= maxRow; ++row)
+        {
+            for (int column = minColumn; column <= maxColumn; ++column)
+            {
+                for (const Item &item : cells[row * columns + column])
+                    fn(item.entity);
+            }
+        }
+    }
+
+    size_t Size() const { return trackedIndices.size(); }
+
+    // Full state, cell order included: which entity a query meets first depends on it,
+    // so a replay has to restore it exactly rather than re-sync from scratch
+    template <typename Writer>
+    void Save(Writer &writer) const
+    {
+        writer.Write(stamp);
+        writer.Write(cells);
+        writer.Write(tracking);
+        writer.Write(trackedIndices);
+    }
+
+    template <typename Reader>
+    void Load(Reader &reader)
+    {
+        reader.Read(stamp);
+        reader.Read(cells);
+        reader.Read(tracking);
+        reader.Read(trackedIndices);
+    }
+
+private:
+    struct Item
+    {
+        Entity entity;
+        Position position;
+    };
+
+    struct Tracked
+    {
+        Entity entity;
+        int cell;      // -1 when not in the grid
+        uint32_t slot; // Index inside the cell's item list
+        uint32_t stamp;
+    };
+
+    int minX;
+    int minY;
+    int columns;
+    int rows;
+    int cellSize;
+    uint32_t stamp;
+    TrackedVector<TrackedVector<Item, MEMORY_ENTITIES>, MEMORY_ENTITIES> cells;
+    TrackedVector<Tracked, MEMORY_ENTITIES> tracking;        // Indexed by Entity::index
+    TrackedVector<uint32_t, MEMORY_ENTITIES> trackedIndices; // Entity indices currently in the grid
+
+    void Place(Entity entity, const Position &position);
+    void RemoveFromCell(Tracked &tracked);
+    void DropStale();
+    void CellCoords(Scalar x, Scalar y, int &column, int &row) const; // Clamped to the grid
+};
+
+#endif // SPATIAL_GRID_H
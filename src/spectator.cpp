@@ -0,0 +1,713 @@
+#include "spectator.h"
+#include "components.h"
+#include "logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    typedef TrackedVector<uint8_t, MEMORY_NETWORK> Bytes;
+
+    const float QUANT = 4;                   // Wire units per pixel
+    const uint32_t NO_TICK = 0xFFFFFFFFu;    // Tick of a frame slot that holds nothing yet
+    const int HISTORY = 64;                  // Frames the host keeps as delta bases; must match the viewer's
+    const uint32_t MAX_UNACKED_TICKS = 32;   // A viewer this far behind on acks gets nothing until it catches up
+    const size_t MAX_PENDING_BYTES = 256 * 1024; // Nor does one whose socket has this much still to take
+    const uint32_t MAX_MESSAGE = 16 * 1024 * 1024;
+
+    // Bits of a command's change mask, one per field that differs from the base
+    enum CommandField
+    {
+        FIELD_SHAPE = 1 << 0,
+        FIELD_X = 1 << 1,
+        FIELD_Y = 1 << 2,
+        FIELD_WIDTH = 1 << 3,
+        FIELD_HEIGHT = 1 << 4,
+        FIELD_COLOR = 1 << 5,
+        FIELD_TEXT = 1 << 6
+    };
+
+    const SpectatorCommand EMPTY_COMMAND = {0, 0, 0, 0, 0, {0, 0, 0, 0}, nullptr};
+
+    void PutVarint(Bytes &out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    // Zigzag, so small differences either way take one byte
+    void PutSigned(Bytes &out, int64_t value)
+    {
+        PutVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void PutDelta(Bytes &out, unsigned &mask, unsigned bit, int32_t value, int32_t base)
+    {
+        if (value == base)
+            return;
+        mask |= bit;
+        PutSigned(out, static_cast<int64_t>(value) - base);
+    }
+
+    bool SameText(const char *a, const char *b)
+    {
+        return a == b || (a && b && strcmp(a, b) == 0);
+    }
+
+    bool SameColor(Color a, Color b)
+    {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+
+    // Bounds-checked reading of one message; any overrun marks it failed
+    struct Reader
+    {
+        const uint8_t *data;
+        const uint8_t *end;
+        bool failed;
+
+        uint8_t Byte()
+        {
+            if (data == end)
+            {
+                failed = true;
+                return 0;
+            }
+            return *data++;
+        }
+
+        uint64_t Varint()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64 && !failed; shift += 7)
+            {
+                uint8_t byte = Byte();
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+            failed = true;
+            return 0;
+        }
+
+        int32_t Delta(int32_t base)
+        {
+            uint64_t zigzag = Varint();
+            int64_t delta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+            return static_cast<int32_t>(base + delta);
+        }
+    };
+
+    // Appends one length-prefixed message holding frame as a difference from base, or whole if base is null
+    void Encode(const SpectatorFrame &frame, const SpectatorFrame *base, Bytes &out)
+    {
+        size_t start = out.size();
+        out.resize(start + 4);
+        PutVarint(out, frame.tick);
+        PutVarint(out, base ? static_cast<uint64_t>(base->tick) + 1 : 0);
+
+        size_t hudMask = out.size();
+        out.push_back(0);
+        for (int i = 0; i < HUD_FIELD_COUNT; ++i)
+        {
+            unsigned mask = 0;
+            PutDelta(out, mask, 1, frame.hud[i], base ? base->hud[i] : 0);
+            out[hudMask] |= static_cast<uint8_t>(mask << i);
+        }
+
+        // Commands are compared with the one at the same position in the base; most entities keep their row
+        PutVarint(out, frame.commands.size());
+        for (size_t i = 0; i < frame.commands.size(); ++i)
+        {
+            const SpectatorCommand &command = frame.commands[i];
+            const SpectatorCommand &was = base && i < base->commands.size() ? base->commands[i] : EMPTY_COMMAND;
+            size_t maskAt = out.size();
+            out.push_back(0);
+            unsigned mask = 0;
+            if (command.shape != was.shape)
+            {
+                mask |= FIELD_SHAPE;
+                out.push_back(command.shape);
+            }
+            PutDelta(out, mask, FIELD_X, command.x, was.x);
+            PutDelta(out, mask, FIELD_Y, command.y, was.y);
+            PutDelta(out, mask, FIELD_WIDTH, command.width, was.width);
+            PutDelta(out, mask, FIELD_HEIGHT, command.height, was.height);
+            if (!SameColor(command.color, was.color))
+            {
+                mask |= FIELD_COLOR;
+                uint8_t rgba[4] = {command.color.r, command.color.g, command.color.b, command.color.a};
+                out.insert(out.end(), rgba, rgba + 4);
+            }
+            if (!SameText(command.text, was.text))
+            {
+                mask |= FIELD_TEXT;
+                size_t length = command.text ? std::min<size_t>(strlen(command.text), 255) : 0;
+                out.push_back(static_cast<uint8_t>(length));
+                out.insert(out.end(), command.text, command.text + length);
+            }
+            out[maskAt] = static_cast<uint8_t>(mask);
+        }
+
+        uint32_t length = static_cast<uint32_t>(out.size() - start - 4);
+        for (int i = 0; i < 4; ++i)
+        {
+            out[start + i] = static_cast<uint8_t>(length >> (8 * i));
+        }
+    }
+
+    int32_t Quantize(float value)
+    {
+        return static_cast<int32_t>(lrintf(value * QUANT));
+    }
+}
+
+SpectatorFrame::SpectatorFrame() : tick(NO_TICK), hud()
+{
+}
+
+bool SpectatorClient::Decode(const uint8_t *data, size_t size)
+{
+    Reader reader = {data, data + size, false};
+    uint64_t tick = reader.Varint();
+    uint64_t baseTick = reader.Varint();
+    const SpectatorFrame *base = nullptr;
+    if (baseTick > 0)
+    {
+        base = &history[(baseTick - 1) % HISTORY];
+        if (base->tick != baseTick - 1)
+            return false; // Never acknowledged, so the host can't have used it
+    }
+    if (reader.failed || tick >= NO_TICK || (base && tick <= base->tick) || (received > 0 && tick <= latest))
+        return false;
+
+    // The base is always another slot: the host only uses bases less than HISTORY ticks old
+    SpectatorFrame &frame = history[tick % HISTORY];
+    frame.tick = NO_TICK; // Not usable until decoded in full
+    uint8_t hudMask = reader.Byte();
+    for (int i = 0; i < HUD_FIELD_COUNT; ++i)
+    {
+        int32_t was = base ? base->hud[i] : 0;
+        frame.hud[i] = hudMask & (1 << i) ? reader.Delta(was) : was;
+    }
+
+    uint64_t count = reader.Varint();
+    if (reader.failed || count > size)
+        return false; // Every command takes at least a byte
+    frame.commands.resize(static_cast<size_t>(count));
+    for (size_t i = 0; i < frame.commands.size() && !reader.failed; ++i)
+    {
+        SpectatorCommand &command = frame.commands[i];
+        command = base && i < base->commands.size() ? base->commands[i] : EMPTY_COMMAND;
+        uint8_t mask = reader.Byte();
+        if (mask & FIELD_SHAPE)
+            command.shape = std::min<uint8_t>(reader.Byte(), SHAPE_TEXT);
+        if (mask & FIELD_X)
+            command.x = reader.Delta(command.x);
+        if (mask & FIELD_Y)
+            command.y = reader.Delta(command.y);
+        if (mask & FIELD_WIDTH)
+            command.width = reader.Delta(command.width);
+        if (mask & FIELD_HEIGHT)
+            command.height = reader.Delta(command.height);
+        if (mask & FIELD_COLOR)
+        {
+            command.color.r = reader.Byte();
+            command.color.g = reader.Byte();
+            command.color.b = reader.Byte();
+            command.color.a = reader.Byte();
+        }
+        if (mask & FIELD_TEXT)
+        {
+            size_t length = reader.Byte();
+            if (static_cast<size_t>(reader.end - reader.data) < length)
+                reader.failed = true;
+            else if (length == 0)
+                command.text = nullptr;
+            else
+                command.text = texts.insert(std::string(reinterpret_cast<const char *>(reader.data), length)).first->c_str();
+            reader.data += reader.failed ? 0 : length;
+        }
+    }
+    if (reader.failed)
+        return false;
+
+    frame.tick = static_cast<uint32_t>(tick);
+    latest = frame.tick;
+    received++;
+    return true;
+}
+
+void SpectatorClient::BuildSnapshot(RenderSnapshot &snapshot) const
+{
+    snapshot.Clear();
+    if (received == 0)
+        return;
+
+    const SpectatorFrame &frame = history[latest % HISTORY];
+    for (const SpectatorCommand &command : frame.commands)
+    {
+        snapshot.commands.push_back({static_cast<DrawShape>(command.shape), command.x / QUANT, command.y / QUANT,
+                                     command.width / QUANT, command.height / QUANT, command.color, command.text});
+    }
+    snapshot.score = frame.hud[HUD_SCORE];
+    snapshot.lives = frame.hud[HUD_LIVES];
+    snapshot.level = frame.hud[HUD_LEVEL];
+    snapshot.wave = frame.hud[HUD_WAVE];
+    snapshot.weaponMode = frame.hud[HUD_WEAPON_MODE];
+    snapshot.weaponTime = frame.hud[HUD_WEAPON_TIME] / 10.0f;
+    snapshot.gameOver = frame.hud[HUD_GAME_OVER] != 0;
+    snapshot.tick = frame.tick;
+    snapshot.inputTime = 0;
+}
+
+void SpectatorServer::Publish(const RenderSnapshot &snapshot)
+{
+    if (viewers.load(std::memory_order_relaxed) == 0)
+        return; // A viewer that connects later starts from a whole frame anyway
+
+    SpectatorFrame &frame = frames.WriteBuffer();
+    frame.tick = ++published;
+    frame.hud[HUD_SCORE] = snapshot.score;
+    frame.hud[HUD_LIVES] = snapshot.lives;
+    frame.hud[HUD_LEVEL] = snapshot.level;
+    frame.hud[HUD_WAVE] = snapshot.wave;
+    frame.hud[HUD_WEAPON_MODE] = snapshot.weaponMode;
+    frame.hud[HUD_WEAPON_TIME] = static_cast<int32_t>(lrintf(snapshot.weaponTime * 10));
+    frame.hud[HUD_GAME_OVER] = snapshot.gameOver;
+    frame.commands.clear();
+    for (const DrawCommand &command : snapshot.commands)
+    {
+        frame.commands.push_back({static_cast<uint8_t>(command.shape), Quantize(command.x), Quantize(command.y),
+                                  Quantize(command.width), Quantize(command.height), command.color, command.text});
+    }
+    frames.Publish();
+
+#ifndef _WIN32
+    uint8_t wake = 0;
+    ssize_t written = write(wakeWrite, &wake, 1); // A full pipe already has the thread awake
+    (void)written;
+#endif
+}
+
+#ifndef _WIN32
+
+namespace
+{
+    bool SetNonBlocking(int socket)
+    {
+        int flags = fcntl(socket, F_GETFL, 0);
+        return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    void SetNoDelay(int socket)
+    {
+        int on = 1;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // Frames are small and latency matters
+    }
+
+    // The broadcast thread's view of one connected viewer
+    struct Viewer
+    {
+        int socket;
+        Bytes pending;     // Encoded frames the socket hasn't taken yet
+        size_t sent;       // Bytes of pending already sent
+        uint32_t ackedTick; // NO_TICK until the first acknowledgement
+        uint32_t sentTick;  // NO_TICK until the first frame
+        uint8_t ack[4];
+        int ackBytes;
+    };
+
+    // Sends what the socket takes without blocking; false if the viewer is gone
+    bool Flush(Viewer &viewer)
+    {
+        while (viewer.sent < viewer.pending.size())
+        {
+            ssize_t written = send(viewer.socket, viewer.pending.data() + viewer.sent, viewer.pending.size() - viewer.sent,
+                                   MSG_NOSIGNAL);
+            if (written < 0)
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            viewer.sent += static_cast<size_t>(written);
+        }
+        viewer.pending.clear();
+        viewer.sent = 0;
+        return true;
+    }
+
+    // Reads the viewer's acknowledgements, four byte ticks; false if the viewer is gone
+    bool ReadAcks(Viewer &viewer)
+    {
+        uint8_t data[256];
+        while (true)
+        {
+            ssize_t count = recv(viewer.socket, data, sizeof(data), 0);
+            if (count == 0)
+                return false;
+            if (count < 0)
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            for (ssize_t i = 0; i < count; ++i)
+            {
+                viewer.ack[viewer.ackBytes++] = data[i];
+                if (viewer.ackBytes < 4)
+                    continue;
+                uint32_t tick = viewer.ack[0] | viewer.ack[1] << 8 | viewer.ack[2] << 16 | static_cast<uint32_t>(viewer.ack[3]) << 24;
+                if (viewer.ackedTick == NO_TICK || tick > viewer.ackedTick)
+                    viewer.ackedTick = tick;
+                viewer.ackBytes = 0;
+            }
+        }
+    }
+}
+
+SpectatorServer::SpectatorServer() : quit(false), viewers(0), published(0), listener(-1), wakeRead(-1), wakeWrite(-1)
+{
+}
+
+SpectatorServer::~SpectatorServer()
+{
+    Stop();
+}
+
+bool SpectatorServer::Start(int port)
+{
+    listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0)
+        return false;
+    int on = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    int wake[2];
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listener, 64) != 0 ||
+        !SetNonBlocking(listener) || pipe(wake) != 0)
+    {
+        close(listener);
+        listener = -1;
+        return false;
+    }
+    wakeRead = wake[0];
+    wakeWrite = wake[1];
+    SetNonBlocking(wakeRead);
+    SetNonBlocking(wakeWrite);
+
+    quit = false;
+    thread = std::thread(&SpectatorServer::Run, this);
+    LOG_INFO("broadcasting to spectators", {{"port", port}});
+    return true;
+}
+
+void SpectatorServer::Stop()
+{
+    if (!thread.joinable())
+        return;
+
+    quit = true;
+    uint8_t wake = 0;
+    ssize_t written = write(wakeWrite, &wake, 1);
+    (void)written;
+    thread.join();
+    close(listener);
+    close(wakeRead);
+    close(wakeWrite);
+    listener = wakeRead = wakeWrite = -1;
+}
+
+void SpectatorServer::Run()
+{
+    TrackedVector<Viewer, MEMORY_NETWORK> connected;
+    TrackedVector<pollfd, MEMORY_NETWORK> polled;
+    TrackedVector<SpectatorFrame, MEMORY_NETWORK> history(HISTORY);
+    uint32_t newest = NO_TICK;
+
+    // Viewers usually share a base, so each distinct base is encoded once per frame
+    struct Encoding
+    {
+        uint32_t base;
+        size_t offset;
+        size_t size;
+    };
+    TrackedVector<Encoding, MEMORY_NETWORK> encodings;
+    Bytes encoded;
+
+    while (!quit)
+    {
+        polled.clear();
+        polled.push_back({wakeRead, POLLIN, 0});
+        polled.push_back({listener, POLLIN, 0});
+        for (const Viewer &viewer : connected)
+        {
+            short events = POLLIN;
+            if (!viewer.pending.empty())
+                events |= POLLOUT;
+            polled.push_back({viewer.socket, events, 0});
+        }
+        if (poll(polled.data(), polled.size(), 100) < 0 && errno != EINTR)
+            break;
+
+        // New frame: hand each viewer that is keeping up the difference from what it last acknowledged
+        if (polled[0].revents & POLLIN)
+        {
+            uint8_t drain[64];
+            while (read(wakeRead, drain, sizeof(drain)) > 0)
+            {
+            }
+            const SpectatorFrame &frame = frames.ReadBuffer();
+            if (frame.tick != NO_TICK && frame.tick != newest)
+            {
+                newest = frame.tick;
+                SpectatorFrame &slot = history[newest % HISTORY];
+                slot.tick = frame.tick;
+                std::copy(frame.hud, frame.hud + HUD_FIELD_COUNT, slot.hud);
+                slot.commands.assign(frame.commands.begin(), frame.commands.end());
+
+                encodings.clear();
+                encoded.clear();
+                for (size_t v = 0; v < connected.size(); ++v)
+                {
+                    Viewer &viewer = connected[v];
+                    bool waitingForAck = viewer.sentTick != NO_TICK &&
+                                         (viewer.ackedTick == NO_TICK || viewer.sentTick - viewer.ackedTick > MAX_UNACKED_TICKS);
+                    if (waitingForAck || viewer.pending.size() - viewer.sent > MAX_PENDING_BYTES)
+                        continue; // Skipped, the next frame it gets jumps ahead
+
+                    uint32_t base = NO_TICK;
+                    if (viewer.ackedTick != NO_TICK && newest - viewer.ackedTick < static_cast<uint32_t>(HISTORY) &&
+                        history[viewer.ackedTick % HISTORY].tick == viewer.ackedTick)
+                        base = viewer.ackedTick;
+                    size_t e = 0;
+                    while (e < encodings.size() && encodings[e].base != base)
+                        e++;
+                    if (e == encodings.size())
+                    {
+                        size_t offset = encoded.size();
+                        Encode(slot, base == NO_TICK ? nullptr : &history[base % HISTORY], encoded);
+                        encodings.push_back({base, offset, encoded.size() - offset});
+                    }
+                    viewer.pending.insert(viewer.pending.end(), encoded.begin() + encodings[e].offset,
+                                          encoded.begin() + encodings[e].offset + encodings[e].size);
+                    viewer.sentTick = newest;
+                    if (!Flush(viewer))
+                    {
+                        close(viewer.socket);
+                        viewer.socket = -1;
+                    }
+                }
+            }
+        }
+
+        for (size_t v = 0; v < connected.size(); ++v)
+        {
+            Viewer &viewer = connected[v];
+            short events = polled[v + 2].revents;
+            if (viewer.socket < 0 || !events)
+                continue;
+            bool alive = !(events & (POLLERR | POLLNVAL));
+            if (alive && (events & (POLLIN | POLLHUP)))
+                alive = ReadAcks(viewer);
+            if (alive && (events & POLLOUT))
+                alive = Flush(viewer);
+            if (!alive)
+            {
+                close(viewer.socket);
+                viewer.socket = -1;
+            }
+        }
+
+        size_t before = connected.size();
+        connected.erase(std::remove_if(connected.begin(), connected.end(), [](const Viewer &viewer)
+                                       { return viewer.socket < 0; }),
+                        connected.end());
+        if (connected.size() != before)
+            LOG_INFO("spectators left", {{"left", before - connected.size()}, {"watching", connected.size()}});
+
+        if (polled[1].revents & POLLIN)
+        {
+            int socket;
+            while ((socket = accept(listener, nullptr, nullptr)) >= 0)
+            {
+                SetNonBlocking(socket);
+                SetNoDelay(socket);
+                Viewer viewer = {socket, Bytes(), 0, NO_TICK, NO_TICK, {0, 0, 0, 0}, 0};
+                connected.push_back(std::move(viewer));
+            }
+            LOG_INFO("spectator joined", {{"watching", connected.size()}});
+        }
+        viewers.store(static_cast<int>(connected.size()), std::memory_order_relaxed);
+    }
+
+    for (const Viewer &viewer : connected)
+    {
+        close(viewer.socket);
+    }
+    viewers.store(0, std::memory_order_relaxed);
+}
+
+SpectatorClient::SpectatorClient() : socket(-1), latest(0), received(0), bytesReceived(0)
+{
+}
+
+SpectatorClient::~SpectatorClient()
+{
+    Close();
+}
+
+bool SpectatorClient::Connect(const std::string &host, int port)
+{
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0)
+        return false;
+    for (addrinfo *address = addresses; address && socket < 0; address = address->ai_next)
+    {
+        socket = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (socket >= 0 && connect(socket, address->ai_addr, address->ai_addrlen) != 0)
+        {
+            close(socket);
+            socket = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (socket < 0 || !SetNonBlocking(socket))
+    {
+        Close();
+        return false;
+    }
+    SetNoDelay(socket);
+    LOG_INFO("spectating", {{"host", host}, {"port", port}});
+    return true;
+}
+
+void SpectatorClient::Close()
+{
+    if (socket < 0)
+        return;
+    close(socket);
+    socket = -1;
+}
+
+bool SpectatorClient::Poll()
+{
+    if (socket < 0)
+        return false;
+
+    uint8_t data[16 * 1024];
+    while (true)
+    {
+        ssize_t count = recv(socket, data, sizeof(data), 0);
+        if (count > 0)
+        {
+            buffer.insert(buffer.end(), data, data + count);
+            bytesReceived += static_cast<size_t>(count);
+            continue;
+        }
+        if (count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        {
+            LOG_INFO("host closed the broadcast");
+            Close();
+            return false;
+        }
+        break;
+    }
+
+    // Decode every complete message in order, each one may be the base of a later one
+    size_t offset = 0;
+    uint32_t acknowledge = NO_TICK;
+    while (buffer.size() - offset >= 4)
+    {
+        uint32_t length = buffer[offset] | buffer[offset + 1] << 8 | buffer[offset + 2] << 16 |
+                          static_cast<uint32_t>(buffer[offset + 3]) << 24;
+        if (length > MAX_MESSAGE)
+        {
+            LOG_ERROR("malformed broadcast", {{"length", length}});
+            Close();
+            return false;
+        }
+        if (buffer.size() - offset - 4 < length)
+            break;
+        if (Decode(buffer.data() + offset + 4, length))
+            acknowledge = latest;
+        offset += 4 + length;
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + offset);
+
+    // One acknowledgement covers everything decoded this poll
+    if (acknowledge != NO_TICK)
+    {
+        uint8_t ack[4] = {static_cast<uint8_t>(acknowledge), static_cast<uint8_t>(acknowledge >> 8),
+                          static_cast<uint8_t>(acknowledge >> 16), static_cast<uint8_t>(acknowledge >> 24)};
+        ssize_t written = send(socket, ack, sizeof(ack), MSG_NOSIGNAL); // A full socket just delays the next delta base
+        (void)written;
+    }
+    return true;
+}
+
+#else
+
+// Spectating needs POSIX sockets; other platforms report it and carry on without
+
+SpectatorServer::SpectatorServer() : quit(false), viewers(0), published(0), listener(-1), wakeRead(-1), wakeWrite(-1)
+{
+}
+
+SpectatorServer::~SpectatorServer()
+{
+}
+
+bool SpectatorServer::Start(int)
+{
+    LOG_ERROR("spectating is not supported on this platform");
+    return false;
+}
+
+void SpectatorServer::Stop()
+{
+}
+
+void SpectatorServer::Run()
+{
+}
+
+SpectatorClient::SpectatorClient() : socket(-1), latest(0), received(0), bytesReceived(0)
+{
+}
+
+SpectatorClient::~SpectatorClient()
+{
+}
+
+bool SpectatorClient::Connect(const std::string &, int)
+{
+    LOG_ERROR("spectating is not supported on this platform");
+    return false;
+}
+
+void SpectatorClient::Close()
+{
+}
+
+bool SpectatorClient::Poll()
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+#include <atomic>
+#include <set>
+#include <string>
+#include <thread>
+#include "snapshot.h"
+#include "triple_buffer.h"
+
+// Spectating over TCP. The host quantizes every tick's RenderSnapshot to quarter pixels and a broadcast
+// thread sends each viewer the difference from the last frame that viewer acknowledged, so a viewer that
+// falls behind is skipped ahead rather than queued up. Viewers draw what they receive and never simulate.
+
+enum SpectatorHud
+{
+    HUD_SCORE,
+    HUD_LIVES,
+    HUD_LEVEL,
+    HUD_WAVE,
+    HUD_WEAPON_MODE,
+    HUD_WEAPON_TIME, // Tenths of a second
+    HUD_GAME_OVER,
+    HUD_FIELD_COUNT
+};
+
+// One draw command as it goes over the wire: positions and sizes in quarter pixels
+struct SpectatorCommand
+{
+    uint8_t shape; // DrawShape
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    Color color;
+    const char *text; // String literal on the host, interned copy on viewers
+};
+
+struct SpectatorFrame
+{
+    uint32_t tick; // Broadcast sequence number, unlike the game's tick it never restarts
+    int32_t hud[HUD_FIELD_COUNT];
+    TrackedVector<SpectatorCommand, MEMORY_NETWORK> commands;
+
+    SpectatorFrame();
+};
+
+// Listens on the loopback interface and broadcasts the host's game to every viewer that connects
+class SpectatorServer
+{
+public:
+    SpectatorServer();
+    ~SpectatorServer();
+    bool Start(int port); // False if the port can't be opened
+    void Stop();
+    void Publish(const RenderSnapshot &snapshot); // From the simulation thread after every tick; cheap with no viewers
+    int Viewers() const { return viewers.load(std::memory_order_relaxed); }
+
+private:
+    TripleBuffer<SpectatorFrame> frames;
+    std::thread thread;
+    std::atomic<bool> quit;
+    std::atomic<int> viewers;
+    uint32_t published; // Frames published, only the publishing thread touches it
+    int listener;
+    int wakeRead; // Self-pipe that wakes the broadcast thread when a frame is published
+    int wakeWrite;
+
+    void Run();
+};
+
+// Connects to a host and rebuilds its snapshots. Everything runs on the calling thread without blocking.
+class SpectatorClient
+{
+public:
+    SpectatorClient();
+    ~SpectatorClient();
+    bool Connect(const std::string &host, int port);
+    void Close();
+    bool Poll(); // Reads and acknowledges whatever arrived; false once the host is gone
+    bool Connected() const { return socket >= 0; }
+    bool HasFrame() const { return received > 0; }
+    void BuildSnapshot(RenderSnapshot &snapshot) const; // Newest frame
+    uint32_t Frame() const { return latest; } // Sequence number of the newest frame
+    unsigned long FramesReceived() const { return received; }
+    size_t BytesReceived() const { return bytesReceived; }
+
+private:
+    static const int HISTORY = 64; // Frames kept as delta bases, by tick
+
+    int socket;
+    TrackedVector<uint8_t, MEMORY_NETWORK> buffer; // Received bytes not yet decoded
+    SpectatorFrame history[HISTORY];
+    uint32_t latest;
+    unsigned long received; // Frames decoded
+    size_t bytesReceived;
+    std::set<std::string> texts; // Interned text of SHAPE_TEXT commands; nodes never move
+
+    bool Decode(const uint8_t *data, size_t size);
+};
+
+#endif // SPECTATOR_H
@@ -0,0 +1,65 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Capacity must be a power of two. Push fails instead of blocking when the ring is full.
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing() : head(0), tail(0) {}
+
+    // Producer side
+    bool Push(const T &item)
+    {
+        size_t write = head.load(std::memory_order_relaxed);
+        if (write - tail.load(std::memory_order_acquire) == Capacity)
+            return false;
+        items[write & (Capacity - 1)] = item;
+        head.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool Pop(T &item)
+    {
+        size_t read = tail.load(std::memory_order_relaxed);
+        if (read == head.load(std::memory_order_acquire))
+            return false;
+        item = items[read & (Capacity - 1)];
+        tail.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: moves up to maxItems into out, returns how many
+    size_t PopMany(T *out, size_t maxItems)
+    {
+        size_t read = tail.load(std::memory_order_relaxed);
+        size_t available = head.load(std::memory_order_acquire) - read;
+        size_t count = available < maxItems ? available : maxItems;
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = items[(read + i) & (Capacity - 1)];
+        }
+        tail.store(read + count, std::memory_order_release);
+        return count;
+    }
+
+    bool Empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+
+private:
+    // Padding keeps the two indices on separate cache lines without over-aligning the type,
+    // which plain new can't honour before C++17
+    T items[Capacity];
+    char itemsPadding[64];
+    std::atomic<size_t> head; // Next slot to write, only the producer stores it
+    char headPadding[64];
+    std::atomic<size_t> tail; // Next slot to read, only the consumer stores it
+};
+
+#endif // SPSC_RING_H
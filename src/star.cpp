@@ -7,11 +7,11 @@ Star::Star(int screenWidth, int screenHeight) {
     color = (Color){ 255, 255, 255, static_cast<unsigned char>(GetRandomValue(100, 255)) };
 }
 
-void Star::Update(int screenHeight) {
+void Star::Update(int screenWidth, int screenHeight) {
     y += speed;
     if (y > screenHeight) {
         y = 0;
-        x = static_cast<float>(GetRandomValue(0, GetScreenWidth())); 
+        x = static_cast<float>(GetRandomValue(0, screenWidth)); 
         speed = static_cast<float>(GetRandomValue(1, 5));
         color.a = static_cast<unsigned char>(GetRandomValue(100, 255));
     }
@@ -19,4 +19,8 @@ void Star::Update(int screenHeight) {
 
 void Star::Draw() const {
     DrawPixel(static_cast<int>(x), static_cast<int>(y), color);
+}
+
+void Star::Draw(RenderSnapshot &snapshot) const {
+    snapshot.AddPixel(x, y, color);
 }
\ No newline at end of file
@@ -2,12 +2,14 @@
 #define STAR_H
 
 #include <raylib.h>
+#include "snapshot.h"
 
 class Star {
 public:
     Star(int screenWidth, int screenHeight);
-    void Update(int screenHeight);
+    void Update(int screenWidth, int screenHeight);
     void Draw() const;
+    void Draw(RenderSnapshot &snapshot) const;
 
 private:
     float x;
@@ -16,4 +18,6 @@ private:
     Color color;
 };
 
+typedef TrackedVector<Star, MEMORY_EFFECTS> StarField;
+
 #endif // STAR_H
\ No newline at end of file
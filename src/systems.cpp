@@ -0,0 +1,718 @@
+#include "systems.h"
+#include "boss.h"
+#include "collision.h"
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+    const Scalar EXPLOSION_DURATION = 0.5f;
+    const Scalar MISSILE_SPEED = 600;
+    const Scalar MISSILE_TURN_RATE = 6;
+    const Scalar MISSILE_LIFETIME = 3;
+    const Scalar SPREAD_ANGLE = 0.15f;     // Radians between neighbouring spread shots
+    const int SPREAD_SHOTS = 5;
+    const Scalar POWER_UP_SPEED = 120;
+    const Scalar BOSS_HOLD_HEIGHT = 220;   // Where the boss stops descending
+    const uint32_t MAX_FUSE_TICKS = 4096;  // A bomb that hasn't gone off by then has long left the screen
+    const int FUSE_TICK_RATE = 60;         // Fuses go off with 1 in 101 odds per tick at this rate
+
+    // survive[n] is the chance a fuse outlasts n ticks at FUSE_TICK_RATE, (100/101)^n, scaled to the
+    // range of Random::Next, so a fuse is one draw and a binary search
+    struct FuseTable
+    {
+        uint32_t survive[MAX_FUSE_TICKS];
+    };
+
+    constexpr FuseTable MakeFuseTable()
+    {
+        FuseTable table{};
+        double chance = 4294967295.0;
+        for (uint32_t n = 0; n < MAX_FUSE_TICKS; ++n)
+        {
+            table.survive[n] = static_cast<uint32_t>(chance);
+            chance *= 100.0 / 101.0;
+        }
+        return table;
+    }
+
+    constexpr FuseTable FUSE_TABLE = MakeFuseTable();
+
+    // Fuse length in seconds, so it doesn't stretch or shrink with the tick rate
+    Scalar RollFuse(Random &random)
+    {
+        uint32_t roll = random.Next();
+        const uint32_t *first = FUSE_TABLE.survive + 1;
+        const uint32_t *end = FUSE_TABLE.survive + MAX_FUSE_TICKS;
+        uint32_t ticks = static_cast<uint32_t>(std::lower_bound(first, end, roll, std::greater<uint32_t>()) - FUSE_TABLE.survive);
+        return Scalar(static_cast<int>(ticks)) / Scalar(FUSE_TICK_RATE);
+    }
+
+    bool SameColor(Color a, Color b)
+    {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+
+    void LoseLife(Pilot &pilot)
+    {
+        pilot.lives--;
+        pilot.exploding = true;
+        pilot.explosionTime = 0.0f;
+        pilot.weaponMode = WEAPON_NORMAL; // Power-ups are lost with the ship
+        pilot.weaponTime = 0;
+    }
+
+    // Projectiles against enemies, using the grid as broadphase. Destroyed enemy positions go to kills.
+    template <typename A>
+    void ProjectileHitSystem(A &projectiles, EnemyArchetype &enemies, BossArchetype &bosses, EmitterArchetype &emitters,
+                             const SpatialGrid &enemyGrid, Scalar deltaTime, TrackedVector<Position, MEMORY_ENTITIES> &kills,
+                             GameEventBuffer &events)
+    {
+        const auto &positions = projectiles.template Column<Position>();
+        const auto &velocities = projectiles.template Column<Velocity>();
+        const auto &bodies = projectiles.template Column<Body>();
+        const auto &enemyPositions = enemies.Column<Position>();
+        auto &enemyBodies = enemies.Column<Body>();
+        auto &health = enemies.Column<Health>();
+        const auto &brains = enemies.Column<EnemyBrain>();
+
+        // The grid buckets enemies by centre, so widen queries by the largest enemy half size
+        Scalar margin = 0;
+        for (const auto &body : enemyBodies)
+        {
+            margin = Max(margin, Max(body.width, body.height) / 2);
+        }
+
+        projectiles.RemoveIf([&](size_t i)
+                             {
+            // Sweep the projectile along this tick's path so fast shots can't step over an enemy,
+            // and hit whichever enemy the path reaches first
+            Box start = GetPreviousBounds(positions[i], velocities[i], bodies[i], deltaTime);
+            Scalar dx = velocities[i].x * deltaTime;
+            Scalar dy = velocities[i].y * deltaTime;
+            Box path = {Min(start.x, start.x + dx) - margin, Min(start.y, start.y + dy) - margin,
+                        start.width + Max(dx, -dx) + margin * 2, start.height + Max(dy, -dy) + margin * 2};
+
+            size_t firstHit = enemies.Size();
+            BossHull *firstHull = nullptr;
+            int firstPart = -1;
+            Scalar firstTime = 2;
+            Scalar entryTime;
+            enemyGrid.ForEachNear(path, [&](Entity entity)
+                                  {
+                if (!enemies.IsAlive(entity))
+                    return;
+                size_t enemy = enemies.GetRow(entity);
+                if (!SweepBox(start, dx, dy, GetBounds(enemyPositions[enemy], enemyBodies[enemy]), entryTime))
+                    return;
+
+                // A boss's body only bounds its parts, the hit has to land on a live part
+                BossHull *hull = nullptr;
+                int part = -1;
+                if (brains[enemy].state == BOSS)
+                {
+                    hull = FindHull(bosses, entity);
+                    if (!hull || !SweepHull(*hull, enemyPositions[enemy], start, dx, dy, entryTime, part))
+                        return;
+                }
+                if (entryTime < firstTime || (entryTime == firstTime && enemy < firstHit))
+                {
+                    firstHit = enemy;
+                    firstHull = hull;
+                    firstPart = part;
+                    firstTime = entryTime;
+                } });
+            if (firstHit == enemies.Size())
+                return false;
+
+            // Handle enemy hit, the projectile that hit is removed
+            bool destroyed = firstHull ? DamagePart(*firstHull, firstPart, enemyBodies[firstHit], health[firstHit], emitters)
+                                       : --health[firstHit].value <= 0;
+            float hitX = ToFloat(positions[i].x);
+            float hitY = ToFloat(positions[i].y);
+            RaiseEvent(events, EVENT_HIT, hitX, hitY, firstHull ? firstHull->parts[firstPart].health : health[firstHit].value,
+                       firstHull != nullptr);
+            if (destroyed)
+            {
+                RaiseEvent(events, EVENT_KILL, ToFloat(enemyPositions[firstHit].x), ToFloat(enemyPositions[firstHit].y));
+                kills.push_back(enemyPositions[firstHit]);
+                enemies.Remove(firstHit);
+            }
+            return true; });
+    }
+
+    // Removes the first projectile whose path this tick crossed the box, returns whether there was one
+    template <typename A>
+    bool HitByAny(A &projectiles, const Box &bounds, Scalar deltaTime)
+    {
+        const auto &positions = projectiles.template Column<Position>();
+        const auto &velocities = projectiles.template Column<Velocity>();
+        const auto &bodies = projectiles.template Column<Body>();
+        Scalar entryTime;
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            Box start = GetPreviousBounds(positions[i], velocities[i], bodies[i], deltaTime);
+            if (SweepBox(start, velocities[i].x * deltaTime, velocities[i].y * deltaTime, bounds, entryTime))
+            {
+                projectiles.Remove(i);
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+Entity SpawnPlayer(PlayerArchetype &players, Scalar x, Scalar y, int spriteWidth, int spriteHeight, const Tuning &tuning)
+{
+    Pilot pilot = {tuning.playerSpeed, 3, false, 0, true, Scalar(spriteWidth), Scalar(spriteHeight), WEAPON_NORMAL, 0};
+    // Collision box uses half the texture size
+    Body body = {Scalar(spriteWidth / 2), Scalar(spriteHeight / 2)};
+    return players.Create({x, y}, body, {tuning.playerCooldown, 0}, pilot);
+}
+
+Entity SpawnEnemy(EnemyArchetype &enemies, Scalar x, Scalar y, Scalar speed, Color color, const Tuning &tuning)
+{
+    // Set health based on color
+    int health = 1;
+    if (SameColor(color, ORANGE))
+        health = 2;
+    else if (SameColor(color, PINK) || SameColor(color, PURPLE))
+        health = 3;
+
+    EnemyBrain brain = {ENTERING, speed, 0, SameColor(color, PURPLE), true};
+    return enemies.Create({x, y}, {20, 20}, {health, health}, {color}, {tuning.enemyCooldown, 0}, brain);
+}
+
+void PlayerSystem(PlayerArchetype &players, ShotArchetype &playerShots, MissileArchetype &missiles, TimerWheel &timers,
+                  const PlayerInput &input, const Tuning &tuning, Scalar deltaTime, int screenWidth, int screenHeight,
+                  GameEventBuffer &events)
+{
+    auto &positions = players.Column<Position>();
+    auto &weapons = players.Column<Weapon>();
+    auto &pilots = players.Column<Pilot>();
+
+    for (size_t i = 0; i < players.Size(); ++i)
+    {
+        Position &position = positions[i];
+        Pilot &pilot = pilots[i];
+        if (pilot.exploding)
+        {
+            pilot.explosionTime += deltaTime;
+            continue;
+        }
+
+        // Frame rate independent movement
+        Scalar step = pilot.movementSpeed * deltaTime * 60;
+        if (input.right)
+            position.x += step;
+        if (input.left)
+            position.x -= step;
+        if (input.up)
+            position.y -= step;
+        if (input.down)
+            position.y += step;
+
+        // Clamp player's horizontal position so the sprite doesn't go off-screen.
+        Scalar halfWidth = pilot.spriteWidth / 2;
+        position.x = Clamp(position.x, halfWidth, screenWidth - halfWidth);
+        position.y = Clamp(position.y, Scalar(0), Scalar(screenHeight));
+
+        // Power-ups run out
+        if (pilot.weaponMode != WEAPON_NORMAL)
+        {
+            pilot.weaponTime -= deltaTime;
+            if (pilot.weaponTime <= 0)
+                pilot.weaponMode = WEAPON_NORMAL;
+        }
+
+        Weapon &weapon = weapons[i];
+        weapon.timeSinceLastShot += deltaTime;
+        if (!input.fire || weapon.timeSinceLastShot < weapon.cooldown)
+            continue;
+
+        // Alternate shooting between left and right cannons
+        Scalar cannonX = pilot.shootFromLeft ? position.x - (pilot.spriteWidth * 0.5f)
+                                             : position.x + (pilot.spriteWidth * 0.01f) - 60;
+        Scalar cannonY = position.y - (pilot.spriteHeight * 0.5f);
+        Scalar shotSpeed = -tuning.playerShotSpeed; // Negative speed to shoot upward
+        int fired = 1;
+        if (pilot.weaponMode == WEAPON_SPREAD)
+        {
+            // Fan of shots centred on straight up
+            for (int shot = 0; shot < SPREAD_SHOTS; ++shot)
+            {
+                Scalar angle = SPREAD_ANGLE * (shot - SPREAD_SHOTS / 2);
+                Velocity velocity = {Sin(angle) * -shotSpeed, Cos(angle) * shotSpeed};
+                playerShots.Create({cannonX, cannonY}, velocity, {8, 10}, {SKYBLUE});
+            }
+            fired = SPREAD_SHOTS;
+        }
+        else
+        {
+            playerShots.Create({cannonX, cannonY}, {0, shotSpeed}, {8, 10}, {BLUE});
+        }
+        if (pilot.weaponMode == WEAPON_HOMING)
+        {
+            // Missiles launch straight up and steer once they are out
+            Entity missile = missiles.Create({cannonX, cannonY}, {0, -MISSILE_SPEED}, {6, 12}, {YELLOW},
+                                             {MISSILE_SPEED, MISSILE_TURN_RATE});
+            timers.Schedule(timers.Now() + TicksFor(MISSILE_LIFETIME, deltaTime), TIMER_MISSILE_EXPIRE, missile);
+            fired++;
+        }
+        RaiseEvent(events, EVENT_SHOT, ToFloat(cannonX), ToFloat(cannonY), pilot.weaponMode, fired);
+        pilot.shootFromLeft = !pilot.shootFromLeft;
+        weapon.timeSinceLastShot = 0; // Reset the timer
+    }
+}
+
+void EnemyBehaviourSystem(EnemyArchetype &enemies, TimerWheel &timers, const Tuning &tuning, Scalar deltaTime, int screenWidth)
+{
+    auto &positions = enemies.Column<Position>();
+    const auto &bodies = enemies.Column<Body>();
+    const auto &weapons = enemies.Column<Weapon>();
+    auto &brains = enemies.Column<EnemyBrain>();
+
+    for (size_t i = 0; i < enemies.Size(); ++i)
+    {
+        Position &position = positions[i];
+        EnemyBrain &brain = brains[i];
+
+        switch (brain.state)
+        {
+        case ENTERING:
+            position.y += brain.speed * deltaTime * 60; // Frame rate independent movement
+            if (position.y > tuning.enemyEnterY)
+            {
+                // Both clocks count from the spawn, so time spent entering is taken off
+                brain.state = FORMATION;
+                Entity entity = enemies.GetEntity(i);
+                timers.Schedule(timers.Now() + TicksFor(weapons[i].cooldown - brain.movementPatternTime, deltaTime),
+                                TIMER_ENEMY_SHOT, entity);
+                timers.Schedule(timers.Now() + TicksFor(tuning.formationTime - brain.movementPatternTime, deltaTime),
+                                TIMER_ENEMY_ATTACK, entity);
+            }
+            break;
+        case FORMATION:
+            break; // Stay in formation until the attack timer fires
+        case ATTACKING:
+            // More complex attack pattern
+            position.y += brain.speed * deltaTime * 40; // Slower descent
+
+            // Swinging left and right while attacking
+            position.x += Cos(brain.movementPatternTime * 2) * brain.speed * deltaTime * 100;
+
+            // Ensure enemies don't go off-screen horizontally
+            position.x = Clamp(position.x, Scalar(20), Scalar(screenWidth - 20));
+            break;
+        case BOSS:
+            if (position.y < BOSS_HOLD_HEIGHT)
+            {
+                position.y += brain.speed * deltaTime * 60;
+            }
+            else
+            {
+                // Slow sweep across the top of the screen
+                Scalar halfWidth = bodies[i].width / 2;
+                position.x += Cos(brain.movementPatternTime * 0.5f) * deltaTime * 120;
+                position.x = Clamp(position.x, halfWidth, screenWidth - halfWidth);
+            }
+            break;
+        }
+
+        brain.movementPatternTime += deltaTime;
+        if (brain.state == FORMATION)
+        {
+            // Gentle swaying
+            position.x += Sin(brain.movementPatternTime * brain.speed) * 1.5f * deltaTime * 60;
+        }
+    }
+}
+
+size_t TimerSystem(TimerWheel &timers, uint32_t tick, EnemyArchetype &enemies, ShotArchetype &enemyShots, BombArchetype &bombs,
+                   MissileArchetype &missiles, const Tuning &tuning, Scalar deltaTime, Random &random)
+{
+    // Timers aren't cancelled, so each handler first checks its entity is still there
+    size_t expired = 0;
+    timers.Advance(tick, [&](const TimerWheel::Timer &timer)
+                   {
+        switch (timer.kind)
+        {
+        case TIMER_ENEMY_SHOT:
+        {
+            if (!enemies.IsAlive(timer.entity))
+                break;
+            const Position &position = enemies.Get<Position>(timer.entity);
+            Position muzzle = {position.x, position.y + 20};
+            if (enemies.Get<EnemyBrain>(timer.entity).dropsBombs)
+            {
+                // Same odds of going off as rolling every 60 Hz tick in flight, rolled up front
+                Entity bomb = bombs.Create(muzzle, {0, tuning.bombSpeed}, {8, 10}, {false, 0});
+                timers.Schedule(timers.Now() + TicksFor(RollFuse(random), deltaTime), TIMER_BOMB_DETONATE, bomb);
+            }
+            else
+            {
+                enemyShots.Create(muzzle, {0, tuning.enemyShotSpeed}, {8, 10}, {RED});
+            }
+            timers.Schedule(timers.Now() + TicksFor(enemies.Get<Weapon>(timer.entity).cooldown, deltaTime), TIMER_ENEMY_SHOT,
+                            timer.entity);
+            break;
+        }
+        case TIMER_ENEMY_ATTACK:
+            if (enemies.IsAlive(timer.entity) && enemies.Get<EnemyBrain>(timer.entity).state == FORMATION)
+            {
+                EnemyBrain &brain = enemies.Get<EnemyBrain>(timer.entity);
+                brain.state = ATTACKING;
+                brain.movementPatternTime = 0;
+            }
+            break;
+        case TIMER_BOMB_DETONATE:
+            if (bombs.IsAlive(timer.entity))
+            {
+                // The bomb stays where it went off
+                Fuse &fuse = bombs.Get<Fuse>(timer.entity);
+                fuse.exploded = true;
+                fuse.explosionTime = 0;
+                bombs.Get<Velocity>(timer.entity) = {0, 0};
+                timers.Schedule(timers.Now() + TicksFor(EXPLOSION_DURATION, deltaTime), TIMER_BOMB_EXPIRE, timer.entity);
+            }
+            break;
+        case TIMER_BOMB_EXPIRE:
+            // A stopped bomb never leaves the screen, so it is retired once its explosion has played out
+            if (bombs.IsAlive(timer.entity))
+            {
+                bombs.Destroy(timer.entity);
+                expired++;
+            }
+            break;
+        case TIMER_MISSILE_EXPIRE:
+            if (missiles.IsAlive(timer.entity))
+            {
+                missiles.Destroy(timer.entity);
+                expired++;
+            }
+            break;
+        } });
+    return expired;
+}
+
+void FuseSystem(BombArchetype &bombs, Scalar deltaTime)
+{
+    for (Fuse &fuse : bombs.Column<Fuse>())
+    {
+        if (fuse.exploded)
+            fuse.explosionTime += deltaTime;
+    }
+}
+
+size_t EnemyVisibilitySystem(EnemyArchetype &enemies, int screenHeight)
+{
+    const auto &positions = enemies.Column<Position>();
+    const auto &bodies = enemies.Column<Body>();
+    auto &brains = enemies.Column<EnemyBrain>();
+
+    for (size_t i = 0; i < enemies.Size(); ++i)
+    {
+        // Nothing reaches above the screen: shots are culled there and enemies don't fire while entering
+        brains[i].asleep = positions[i].y + bodies[i].height / 2 < 0;
+    }
+    return enemies.RemoveIf([&](size_t i)
+                            { return brains[i].state == ATTACKING && positions[i].y - bodies[i].height / 2 > screenHeight; });
+}
+
+void HomingSystem(MissileArchetype &missiles, const SpatialGrid &enemyGrid, Scalar deltaTime)
+{
+    const auto &positions = missiles.Column<Position>();
+    auto &velocities = missiles.Column<Velocity>();
+    const auto &homing = missiles.Column<Homing>();
+
+    for (size_t i = 0; i < missiles.Size(); ++i)
+    {
+        Entity target;
+        Position targetPosition;
+        if (!enemyGrid.FindNearest(positions[i].x, positions[i].y, target, targetPosition))
+            continue; // Nothing to chase, keep flying straight
+
+        Scalar dx = targetPosition.x - positions[i].x;
+        Scalar dy = targetPosition.y - positions[i].y;
+        Scalar distance = Length(dx, dy);
+        if (distance <= 0)
+            continue;
+
+        // Swing the velocity towards the target at the missile's turn rate
+        Scalar blend = Min(Scalar(1), homing[i].turnRate * deltaTime);
+        Velocity &velocity = velocities[i];
+        velocity.x += (dx / distance * homing[i].speed - velocity.x) * blend;
+        velocity.y += (dy / distance * homing[i].speed - velocity.y) * blend;
+    }
+}
+
+void ShotCollisionSystem(ShotArchetype &playerShots, EnemyArchetype &enemies, BossArchetype &bosses, EmitterArchetype &emitters,
+                         const SpatialGrid &enemyGrid, Scalar deltaTime, TrackedVector<Position, MEMORY_ENTITIES> &kills,
+                         GameEventBuffer &events)
+{
+    ProjectileHitSystem(playerShots, enemies, bosses, emitters, enemyGrid, deltaTime, kills, events);
+}
+
+void ShotCollisionSystem(MissileArchetype &missiles, EnemyArchetype &enemies, BossArchetype &bosses, EmitterArchetype &emitters,
+                         const SpatialGrid &enemyGrid, Scalar deltaTime, TrackedVector<Position, MEMORY_ENTITIES> &kills,
+                         GameEventBuffer &events)
+{
+    ProjectileHitSystem(missiles, enemies, bosses, emitters, enemyGrid, deltaTime, kills, events);
+}
+
+void PowerUpDropSystem(const TrackedVector<Position, MEMORY_ENTITIES> &kills, PowerUpArchetype &powerUps, const Tuning &tuning,
+                       Random &random)
+{
+    for (const Position &position : kills)
+    {
+        if (random.Range(0, 99) >= tuning.powerUpDropPercent)
+            continue;
+        WeaponMode weaponMode = random.Range(0, 1) == 0 ? WEAPON_SPREAD : WEAPON_HOMING;
+        powerUps.Create(position, {0, POWER_UP_SPEED}, {24, 24}, {weaponMode});
+    }
+}
+
+void PowerUpPickupSystem(PlayerArchetype &players, PowerUpArchetype &powerUps, const Tuning &tuning, GameEventBuffer &events)
+{
+    const auto &positions = players.Column<Position>();
+    const auto &bodies = players.Column<Body>();
+    auto &pilots = players.Column<Pilot>();
+    const auto &powerUpPositions = powerUps.Column<Position>();
+    const auto &powerUpBodies = powerUps.Column<Body>();
+    const auto &kinds = powerUps.Column<PowerUp>();
+
+    for (size_t i = 0; i < players.Size(); ++i)
+    {
+        Pilot &pilot = pilots[i];
+        if (pilot.exploding)
+            continue;
+
+        Box bounds = GetBounds(positions[i], bodies[i]);
+        powerUps.RemoveIf([&](size_t powerUp)
+                          {
+            if (!Overlaps(bounds, GetBounds(powerUpPositions[powerUp], powerUpBodies[powerUp])))
+                return false;
+            // A new pickup replaces the current power-up and restarts its timer
+            pilot.weaponMode = kinds[powerUp].weaponMode;
+            pilot.weaponTime = tuning.powerUpDuration;
+            RaiseEvent(events, EVENT_POWER_UP, ToFloat(powerUpPositions[powerUp].x), ToFloat(powerUpPositions[powerUp].y),
+                       pilot.weaponMode);
+            return true; });
+    }
+}
+
+int PlayerCollisionSystem(PlayerArchetype &players, const EnemyArchetype &enemies, const BossArchetype &bosses,
+                          ShotArchetype &enemyShots, BombArchetype &bombs, Scalar deltaTime)
+{
+    const auto &positions = players.Column<Position>();
+    const auto &bodies = players.Column<Body>();
+    auto &pilots = players.Column<Pilot>();
+    const auto &enemyPositions = enemies.Column<Position>();
+    const auto &enemyBodies = enemies.Column<Body>();
+    const auto &brains = enemies.Column<EnemyBrain>();
+
+    int playersHit = 0;
+    for (size_t i = 0; i < players.Size(); ++i)
+    {
+        Pilot &pilot = pilots[i];
+        if (pilot.exploding)
+            continue;
+
+        Box bounds = GetBounds(positions[i], bodies[i]);
+        bool hit = false;
+
+        // Check for collisions between player and enemies
+        for (size_t enemy = 0; enemy < enemies.Size() && !hit; ++enemy)
+        {
+            if (brains[enemy].asleep)
+                continue;
+            hit = Overlaps(bounds, GetBounds(enemyPositions[enemy], enemyBodies[enemy]));
+            if (hit && brains[enemy].state == BOSS)
+            {
+                const BossHull *hull = FindHull(bosses, enemies.GetEntity(enemy));
+                hit = hull && OverlapsHull(*hull, enemyPositions[enemy], bounds);
+            }
+        }
+
+        // Check for collisions between player and enemy projectiles
+        hit = hit || HitByAny(enemyShots, bounds, deltaTime) || HitByAny(bombs, bounds, deltaTime);
+
+        if (hit)
+        {
+            LoseLife(pilot);
+            playersHit++;
+        }
+    }
+    return playersHit;
+}
+
+void RespawnSystem(PlayerArchetype &players, const EnemyArchetype &enemies, int screenWidth, int screenHeight)
+{
+    auto &positions = players.Column<Position>();
+    const auto &bodies = players.Column<Body>();
+    auto &pilots = players.Column<Pilot>();
+    const auto &enemyPositions = enemies.Column<Position>();
+    const auto &enemyBodies = enemies.Column<Body>();
+
+    for (size_t i = 0; i < players.Size(); ++i)
+    {
+        Pilot &pilot = pilots[i];
+        if (!pilot.exploding || pilot.explosionTime < 2)
+            continue;
+
+        // Wait until no on-screen enemy is near the spot where the player went down
+        Box clearance = {positions[i].x - bodies[i].width, positions[i].y - bodies[i].height,
+                         bodies[i].width * 2, bodies[i].height * 2};
+        bool enemiesCleared = true;
+        for (size_t enemy = 0; enemy < enemies.Size(); ++enemy)
+        {
+            if (enemyPositions[enemy].y <= screenHeight &&
+                Overlaps(clearance, GetBounds(enemyPositions[enemy], enemyBodies[enemy])))
+            {
+                enemiesCleared = false;
+                break;
+            }
+        }
+        if (enemiesCleared)
+        {
+            positions[i] = {Scalar(screenWidth) / 2, Scalar(screenHeight) * 0.9f};
+            pilot.exploding = false;
+        }
+    }
+}
+
+bool AllEnemiesGone(const EnemyArchetype &enemies, int screenHeight)
+{
+    for (const auto &position : enemies.Column<Position>())
+    {
+        if (position.y <= screenHeight)
+            return false;
+    }
+    return true;
+}
+
+void RenderShots(const ShotArchetype &shots, const Box &viewport, RenderSnapshot &snapshot)
+{
+    const auto &positions = shots.Column<Position>();
+    const auto &bodies = shots.Column<Body>();
+    const auto &tints = shots.Column<Tint>();
+    for (size_t i = 0; i < shots.Size(); ++i)
+    {
+        Box bounds = GetBounds(positions[i], bodies[i]);
+        if (!Overlaps(viewport, bounds))
+            continue;
+        snapshot.entities.drawn++;
+        snapshot.AddRectangle(ToFloat(bounds.x), ToFloat(bounds.y), ToFloat(bounds.width), ToFloat(bounds.height), tints[i].color);
+    }
+}
+
+void RenderBombs(const BombArchetype &bombs, const Box &viewport, RenderSnapshot &snapshot)
+{
+    const auto &positions = bombs.Column<Position>();
+    const auto &fuses = bombs.Column<Fuse>();
+    for (size_t i = 0; i < bombs.Size(); ++i)
+    {
+        Scalar radius = fuses[i].exploded ? fuses[i].explosionTime * 50 : Scalar(5);
+        if (!Overlaps(viewport, {positions[i].x - radius, positions[i].y - radius, radius * 2, radius * 2}))
+            continue;
+        snapshot.entities.drawn++;
+
+        if (!fuses[i].exploded)
+        {
+            snapshot.AddCircle(ToFloat(positions[i].x), ToFloat(positions[i].y), 5, DARKGRAY); // Draw bomb shape
+        }
+        else if (fuses[i].explosionTime < EXPLOSION_DURATION)
+        {
+            // Draw explosion effect
+            snapshot.AddCircle(ToFloat(positions[i].x), ToFloat(positions[i].y), ToFloat(fuses[i].explosionTime) * 50.0f, ORANGE);
+        }
+    }
+}
+
+void RenderMissiles(const MissileArchetype &missiles, const Box &viewport, RenderSnapshot &snapshot)
+{
+    const auto &positions = missiles.Column<Position>();
+    const auto &bodies = missiles.Column<Body>();
+    const auto &tints = missiles.Column<Tint>();
+    for (size_t i = 0; i < missiles.Size(); ++i)
+    {
+        Box bounds = GetBounds(positions[i], bodies[i]);
+        if (!Overlaps(viewport, bounds))
+            continue;
+        snapshot.entities.drawn++;
+        snapshot.AddRectangle(ToFloat(bounds.x), ToFloat(bounds.y), ToFloat(bounds.width), ToFloat(bounds.height), tints[i].color);
+    }
+}
+
+void RenderPowerUps(const PowerUpArchetype &powerUps, const Box &viewport, RenderSnapshot &snapshot)
+{
+    const auto &positions = powerUps.Column<Position>();
+    const auto &bodies = powerUps.Column<Body>();
+    const auto &kinds = powerUps.Column<PowerUp>();
+    for (size_t i = 0; i < powerUps.Size(); ++i)
+    {
+        if (!Overlaps(viewport, GetBounds(positions[i], bodies[i])))
+            continue;
+        snapshot.entities.drawn++;
+
+        float x = ToFloat(positions[i].x);
+        float y = ToFloat(positions[i].y);
+        bool spread = kinds[i].weaponMode == WEAPON_SPREAD;
+        snapshot.AddCircle(x, y, 12, spread ? SKYBLUE : GOLD);
+        snapshot.AddText(spread ? "S" : "H", x - 5, y - 9, 20, BLACK);
+    }
+}
+
+void RenderEnemies(const EnemyArchetype &enemies, const Box &viewport, RenderSnapshot &snapshot)
+{
+    const auto &positions = enemies.Column<Position>();
+    const auto &bodies = enemies.Column<Body>();
+    const auto &health = enemies.Column<Health>();
+    const auto &tints = enemies.Column<Tint>();
+    const auto &brains = enemies.Column<EnemyBrain>();
+    for (size_t i = 0; i < enemies.Size(); ++i)
+    {
+        if (brains[i].state == BOSS)
+            continue; // Drawn part by part in RenderBosses
+        if (!Overlaps(viewport, GetBounds(positions[i], bodies[i])))
+            continue;
+        snapshot.entities.drawn++;
+
+        int x = static_cast<int>(ToFloat(positions[i].x));
+        int y = static_cast<int>(ToFloat(positions[i].y));
+        int width = static_cast<int>(ToFloat(bodies[i].width));
+        int height = static_cast<int>(ToFloat(bodies[i].height));
+
+        // Draw enemy with half size: 20x20 instead of 40x40
+        snapshot.AddRectangle(x - width / 2, y - height / 2, width, height, tints[i].color);
+
+        // Draw health indicator
+        for (int h = 0; h < health[i].value; h++)
+        {
+            snapshot.AddRectangle(x - 8 + h * 8, y - height / 2 - 5, 5, 2, GREEN);
+        }
+    }
+}
+
+void RenderPlayers(const PlayerArchetype &players, RenderSnapshot &snapshot)
+{
+    const auto &positions = players.Column<Position>();
+    const auto &pilots = players.Column<Pilot>();
+    for (size_t i = 0; i < players.Size(); ++i)
+    {
+        int x = static_cast<int>(ToFloat(positions[i].x));
+        int y = static_cast<int>(ToFloat(positions[i].y));
+        const Pilot &pilot = pilots[i];
+        snapshot.entities.drawn++; // Players never leave the screen
+        if (pilot.exploding)
+        {
+            snapshot.AddText("BOOM!", x - 20, y - 10, 20, RED);
+            continue;
+        }
+        // Scale factor: original scale 0.6 halved -> 0.3
+        float spriteWidth = ToFloat(pilot.spriteWidth);
+        float spriteHeight = ToFloat(pilot.spriteHeight);
+        snapshot.AddSprite(x - static_cast<int>(spriteWidth) / 2, y - static_cast<int>(spriteHeight) / 2,
+                           spriteWidth * 0.3f, spriteHeight * 0.3f);
+    }
+}
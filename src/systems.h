@@ -0,0 +1,86 @@
+#ifndef SYSTEMS_H
+#define SYSTEMS_H
+
+#include "components.h"
+#include "events.h"
+#include "input.h"
+#include "random.h"
+#include "snapshot.h"
+#include "spatial_grid.h"
+#include "timer_wheel.h"
+#include "tuning.h"
+
+// Spawning
+Entity SpawnPlayer(PlayerArchetype &players, Scalar x, Scalar y, int spriteWidth, int spriteHeight, const Tuning &tuning);
+Entity SpawnEnemy(EnemyArchetype &enemies, Scalar x, Scalar y, Scalar speed, Color color, const Tuning &tuning);
+
+// Simulation systems, run in this order by HandleGameplay
+// Advances the timers to tick and acts on the ones due: enemy shots and dives, bomb fuses, and the end of
+// explosions and missiles. Returns how many entities expired.
+size_t TimerSystem(TimerWheel &timers, uint32_t tick, EnemyArchetype &enemies, ShotArchetype &enemyShots, BombArchetype &bombs,
+                   MissileArchetype &missiles, const Tuning &tuning, Scalar deltaTime, Random &random);
+void PlayerSystem(PlayerArchetype &players, ShotArchetype &playerShots, MissileArchetype &missiles, TimerWheel &timers,
+                  const PlayerInput &input, const Tuning &tuning, Scalar deltaTime, int screenWidth, int screenHeight,
+                  GameEventBuffer &events);
+// Moves enemies; an enemy taking up its place in the formation gets its shot and dive timers
+void EnemyBehaviourSystem(EnemyArchetype &enemies, TimerWheel &timers, const Tuning &tuning, Scalar deltaTime, int screenWidth);
+void FuseSystem(BombArchetype &bombs, Scalar deltaTime); // Grows explosions
+// Puts enemies still wholly above the screen to sleep and wakes them as they appear. Attackers that
+// dived past the bottom never come back, so they are retired; returns how many.
+size_t EnemyVisibilitySystem(EnemyArchetype &enemies, int screenHeight);
+void HomingSystem(MissileArchetype &missiles, const SpatialGrid &enemyGrid, Scalar deltaTime); // Steers at the nearest enemy
+// Projectiles are swept along their path for the tick, so nothing tunnels through at low tick rates.
+// Positions of destroyed enemies are appended to kills, and every hit and kill raises an event.
+// Boss hits descend into the boss's part hierarchy; destroyed parts take their emitters with them.
+void ShotCollisionSystem(ShotArchetype &playerShots, EnemyArchetype &enemies, BossArchetype &bosses, EmitterArchetype &emitters,
+                         const SpatialGrid &enemyGrid, Scalar deltaTime, TrackedVector<Position, MEMORY_ENTITIES> &kills,
+                         GameEventBuffer &events);
+void ShotCollisionSystem(MissileArchetype &missiles, EnemyArchetype &enemies, BossArchetype &bosses, EmitterArchetype &emitters,
+                         const SpatialGrid &enemyGrid, Scalar deltaTime, TrackedVector<Position, MEMORY_ENTITIES> &kills,
+                         GameEventBuffer &events);
+void PowerUpDropSystem(const TrackedVector<Position, MEMORY_ENTITIES> &kills, PowerUpArchetype &powerUps, const Tuning &tuning,
+                       Random &random);
+void PowerUpPickupSystem(PlayerArchetype &players, PowerUpArchetype &powerUps, const Tuning &tuning, GameEventBuffer &events);
+int PlayerCollisionSystem(PlayerArchetype &players, const EnemyArchetype &enemies, const BossArchetype &bosses,
+                          ShotArchetype &enemyShots, BombArchetype &bombs, Scalar deltaTime); // Returns how many players were hit
+void RespawnSystem(PlayerArchetype &players, const EnemyArchetype &enemies, int screenWidth, int screenHeight);
+bool AllEnemiesGone(const EnemyArchetype &enemies, int screenHeight);
+
+// Moves everything that has a velocity. Walks raw column pointers with the count hoisted,
+// so the loop vectorizes; with thousands of bullets this is the hottest loop in the game.
+template <typename A>
+void MovementSystem(A &archetype, Scalar deltaTime)
+{
+    Position *positions = archetype.template Column<Position>().data();
+    const Velocity *velocities = archetype.template Column<Velocity>().data();
+    size_t count = archetype.Size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        positions[i].x += velocities[i].x * deltaTime;
+        positions[i].y += velocities[i].y * deltaTime;
+    }
+}
+
+// Drops projectiles that left the screen in their direction of travel; returns how many
+template <typename A>
+size_t OffScreenSystem(A &archetype, int screenWidth, int screenHeight)
+{
+    const auto &positions = archetype.template Column<Position>();
+    const auto &velocities = archetype.template Column<Velocity>();
+    const auto &bodies = archetype.template Column<Body>();
+    return archetype.RemoveIf([&](size_t i)
+                       { return (velocities[i].y < 0 && positions[i].y + bodies[i].height < 0) ||
+                                (velocities[i].y > 0 && positions[i].y > screenHeight) ||
+                                (velocities[i].x < 0 && positions[i].x + bodies[i].width < 0) ||
+                                (velocities[i].x > 0 && positions[i].x - bodies[i].width > screenWidth); });
+}
+
+// Rendering into the snapshot. Entities outside the viewport are skipped; the rest count towards snapshot.entities.drawn.
+void RenderShots(const ShotArchetype &shots, const Box &viewport, RenderSnapshot &snapshot);
+void RenderBombs(const BombArchetype &bombs, const Box &viewport, RenderSnapshot &snapshot);
+void RenderMissiles(const MissileArchetype &missiles, const Box &viewport, RenderSnapshot &snapshot);
+void RenderPowerUps(const PowerUpArchetype &powerUps, const Box &viewport, RenderSnapshot &snapshot);
+void RenderEnemies(const EnemyArchetype &enemies, const Box &viewport, RenderSnapshot &snapshot);
+void RenderPlayers(const PlayerArchetype &players, RenderSnapshot &snapshot);
+
+#endif // SYSTEMS_H
@@ -0,0 +1,251 @@
+#include "telemetry.h"
+#include "memory.h"
+#include "spsc_ring.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const char MAGIC[4] = {'G', 'T', 'E', 'L'};
+    const uint32_t VERSION = 1;
+    const size_t RING_CAPACITY = 8192; // Records per thread between flushes
+    const std::chrono::milliseconds FLUSH_INTERVAL(100);
+
+    const char *EVENT_NAMES[TELEMETRY_EVENT_COUNT] = {
+        "session", "shot", "hit", "kill", "death", "wave", "game_over", "power_up", "frame", "dropped", "latency", "pacing"};
+
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t recordSize; // sizeof(TelemetryRecord) of the build that wrote the file
+        uint32_t reserved;
+        int64_t startTime;   // Unix time the session started
+    };
+
+    struct ThreadRing
+    {
+        SpscRing<TelemetryRecord, RING_CAPACITY> ring;
+        std::atomic<uint32_t> dropped; // Records lost since the writer last reported
+        uint16_t id;
+    };
+
+    // Rings are never freed, so a thread's cached pointer stays valid across sessions
+    std::mutex ringsMutex;
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    thread_local ThreadRing *threadRing = nullptr;
+    thread_local uint32_t threadTick = 0;
+
+    std::atomic<bool> enabled(false);
+    Clock::time_point sessionStart;
+    FILE *file = nullptr;
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    ThreadRing &GetThreadRing()
+    {
+        if (!threadRing)
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            rings.emplace_back(new ThreadRing());
+            TrackAllocation(MEMORY_TELEMETRY, sizeof(ThreadRing)); // Lives as long as the process
+            threadRing = rings.back().get();
+            threadRing->dropped = 0;
+            threadRing->id = static_cast<uint16_t>(rings.size() - 1);
+        }
+        return *threadRing;
+    }
+
+    // Writer thread only
+    void Flush(TrackedVector<TelemetryRecord, MEMORY_TELEMETRY> &buffer)
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (auto &entry : rings)
+        {
+            size_t count;
+            while ((count = entry->ring.PopMany(buffer.data(), buffer.size())) > 0)
+            {
+                fwrite(buffer.data(), sizeof(TelemetryRecord), count, file);
+            }
+
+            uint32_t dropped = entry->dropped.exchange(0);
+            if (dropped > 0)
+            {
+                uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sessionStart).count();
+                TelemetryRecord record = {now, 0, TELEMETRY_DROPPED, entry->id, static_cast<int32_t>(dropped), 0};
+                fwrite(&record, sizeof(record), 1, file);
+            }
+        }
+        fflush(file); // Keep what we have if the game crashes
+    }
+
+    void WriterLoop()
+    {
+        TrackedVector<TelemetryRecord, MEMORY_TELEMETRY> buffer(RING_CAPACITY);
+        bool done = false;
+        while (!done)
+        {
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wake.wait_for(lock, FLUSH_INTERVAL, []
+                              { return stopping; });
+                done = stopping;
+            }
+            Flush(buffer);
+        }
+    }
+}
+
+bool StartTelemetry(const char *path)
+{
+    if (file)
+        return false;
+
+    file = fopen(path, "wb");
+    if (!file)
+        return false;
+
+    FileHeader header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.recordSize = sizeof(TelemetryRecord);
+    header.startTime = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+                                                std::chrono::system_clock::now().time_since_epoch())
+                                                .count());
+    fwrite(&header, sizeof(header), 1, file);
+
+    sessionStart = Clock::now();
+    stopping = false;
+    writer = std::thread(WriterLoop);
+    enabled.store(true, std::memory_order_release);
+    return true;
+}
+
+void StopTelemetry()
+{
+    if (!file)
+        return;
+
+    enabled.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+    fclose(file);
+    file = nullptr;
+}
+
+void SetTelemetryTick(uint32_t tick)
+{
+    threadTick = tick;
+}
+
+void RecordTelemetry(TelemetryEvent event, int32_t a, int32_t b)
+{
+    if (!enabled.load(std::memory_order_acquire))
+        return;
+
+    ThreadRing &ring = GetThreadRing();
+    uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sessionStart).count();
+    TelemetryRecord record = {now, threadTick, static_cast<uint16_t>(event), ring.id, a, b};
+    if (!ring.ring.Push(record))
+    {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed); // Never block the game on the writer
+    }
+}
+
+int DecodeTelemetry(const char *path)
+{
+    FILE *input = fopen(path, "rb");
+    if (!input)
+    {
+        fprintf(stderr, "Can't open %s\n", path);
+        return 1;
+    }
+
+    FileHeader header;
+    if (fread(&header, sizeof(header), 1, input) != 1 || memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION || header.recordSize != sizeof(TelemetryRecord))
+    {
+        fprintf(stderr, "%s is not a version %u telemetry file\n", path, VERSION);
+        fclose(input);
+        return 1;
+    }
+
+    std::vector<TelemetryRecord> records;
+    TelemetryRecord record;
+    while (fread(&record, sizeof(record), 1, input) == 1)
+    {
+        records.push_back(record);
+    }
+    fclose(input);
+
+    // Rings are flushed one after another, so put the threads back in time order
+    std::stable_sort(records.begin(), records.end(), [](const TelemetryRecord &a, const TelemetryRecord &b)
+                     { return a.time < b.time; });
+
+    printf("# session started at unix time %lld, %zu records\n", static_cast<long long>(header.startTime), records.size());
+    printf("# time_ms tick thread event a b\n");
+    unsigned long counts[TELEMETRY_EVENT_COUNT] = {};
+    double frameTotal = 0;
+    int32_t frameWorst = 0;
+    double latencyTotal = 0;
+    int32_t latencyWorst = 0;
+    double jitterTotal = 0;
+    int32_t jitterWorst = 0;
+    for (const TelemetryRecord &r : records)
+    {
+        const char *name = r.event < TELEMETRY_EVENT_COUNT ? EVENT_NAMES[r.event] : "unknown";
+        printf("%.3f %u %u %s %d %d\n", r.time / 1e6, r.tick, r.thread, name, r.a, r.b);
+        if (r.event < TELEMETRY_EVENT_COUNT)
+            counts[r.event]++;
+        if (r.event == TELEMETRY_FRAME)
+        {
+            frameTotal += r.a;
+            frameWorst = std::max(frameWorst, r.a);
+        }
+        else if (r.event == TELEMETRY_LATENCY)
+        {
+            latencyTotal += r.a;
+            latencyWorst = std::max(latencyWorst, r.a);
+        }
+        else if (r.event == TELEMETRY_PACING)
+        {
+            jitterTotal += std::abs(r.b);
+            jitterWorst = std::max(jitterWorst, std::abs(r.b));
+        }
+    }
+
+    printf("# summary\n");
+    for (int event = 0; event < TELEMETRY_EVENT_COUNT; ++event)
+    {
+        printf("#   %-10s %lu\n", EVENT_NAMES[event], counts[event]);
+    }
+    if (counts[TELEMETRY_FRAME] > 0)
+    {
+        printf("#   frame time avg %.2f ms, worst %.2f ms\n", frameTotal / counts[TELEMETRY_FRAME] / 1000.0, frameWorst / 1000.0);
+    }
+    if (counts[TELEMETRY_LATENCY] > 0)
+    {
+        printf("#   input latency avg %.2f ms, worst %.2f ms\n", latencyTotal / counts[TELEMETRY_LATENCY] / 1000.0, latencyWorst / 1000.0);
+    }
+    if (counts[TELEMETRY_PACING] > 0)
+    {
+        printf("#   frame jitter avg %.3f ms, worst %.3f ms\n", jitterTotal / counts[TELEMETRY_PACING] / 1000.0, jitterWorst / 1000.0);
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <cstdint>
+
+// Binary gameplay telemetry. Each thread records into its own lock-free ring and a background
+// writer drains the rings to disk, so recording is a clock read and a few stores.
+// Recording is a no-op until StartTelemetry is called.
+
+enum TelemetryEvent
+{
+    TELEMETRY_SESSION,   // a = world seed
+    TELEMETRY_SHOT,      // a = weapon mode, b = projectiles fired
+    TELEMETRY_HIT,       // a = health left on the target, b = 1 when it was a boss part
+    TELEMETRY_KILL,      // a = x, b = y
+    TELEMETRY_DEATH,     // a = lives left
+    TELEMETRY_WAVE,      // a = level, b = wave
+    TELEMETRY_GAME_OVER, // a = score
+    TELEMETRY_POWER_UP,  // a = weapon mode picked up
+    TELEMETRY_FRAME,     // a = frame time, b = CPU work time, both in microseconds
+    TELEMETRY_DROPPED,   // Written by the writer: a = records lost to a full ring
+    TELEMETRY_LATENCY,   // a = input-to-present latency in microseconds
+    TELEMETRY_PACING,    // a = present-to-present interval, b = interval minus the target period, both in microseconds
+    TELEMETRY_EVENT_COUNT
+};
+
+struct TelemetryRecord
+{
+    uint64_t time;   // Nanoseconds since the session started
+    uint32_t tick;   // Simulation tick the event belongs to
+    uint16_t event;  // TelemetryEvent
+    uint16_t thread; // Ring the record came through
+    int32_t a;
+    int32_t b;
+};
+
+bool StartTelemetry(const char *path); // Opens the file and starts the writer thread
+void StopTelemetry();                  // Flushes everything recorded so far and closes the file
+void SetTelemetryTick(uint32_t tick);  // Tick stamped on this thread's following records
+void RecordTelemetry(TelemetryEvent event, int32_t a = 0, int32_t b = 0);
+
+int DecodeTelemetry(const char *path); // Prints a recording as text, for --decode-telemetry
+
+#endif // TELEMETRY_H
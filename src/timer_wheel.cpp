@@ -0,0 +1,64 @@
+#include "timer_wheel.h"
+
+TimerWheel::TimerWheel() : now(0), pending(0), slots(LEVELS * SLOTS)
+{
+}
+
+void TimerWheel::Clear(uint32_t now)
+{
+    this->now = now;
+    pending = 0;
+    for (auto &slot : slots)
+    {
+        slot.clear();
+    }
+}
+
+void TimerWheel::Schedule(uint32_t due, TimerKind kind, Entity entity)
+{
+    if (due <= now)
+        due = now + 1;
+    Insert({due, kind, entity});
+    pending++;
+}
+
+void TimerWheel::Insert(const Timer &timer)
+{
+    // A timer sits on the lowest level whose current span (the slot now is in one level up) holds its due tick,
+    // in the slot for its due tick at that level's resolution. That slot is always ahead of now's, so it is
+    // cascaded or fired no earlier than the timer is due.
+    int level = 0;
+    while (level < LEVELS && (timer.due >> (SLOT_BITS * (level + 1))) != (now >> (SLOT_BITS * (level + 1))))
+        level++;
+    uint32_t slot;
+    if (level == LEVELS)
+    {
+        // Beyond the wheel: park in the next top level slot to cascade and try again from there
+        level = LEVELS - 1;
+        slot = (now >> (SLOT_BITS * level)) + 1;
+    }
+    else
+    {
+        slot = timer.due >> (SLOT_BITS * level);
+    }
+    slots[level * SLOTS + (slot & (SLOTS - 1))].push_back(timer);
+}
+
+void TimerWheel::Cascade()
+{
+    // Whenever a level wraps, the slot now enters on the level above is spread over the levels below.
+    // Higher levels go first, so a timer can fall several levels in one step.
+    int top = 0;
+    while (top < LEVELS - 1 && (now & ((1u << (SLOT_BITS * (top + 1))) - 1)) == 0)
+        top++;
+    for (int level = top; level > 0; --level)
+    {
+        auto &slot = slots[level * SLOTS + ((now >> (SLOT_BITS * level)) & (SLOTS - 1))];
+        firing.swap(slot);
+        for (const Timer &timer : firing)
+        {
+            Insert(timer);
+        }
+        firing.clear();
+    }
+}
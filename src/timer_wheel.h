@@ -0,0 +1,93 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "ecs.h"
+#include "fixed.h"
+
+enum TimerKind : uint32_t
+{
+    TIMER_ENEMY_SHOT,     // Enemy fires and rearms
+    TIMER_ENEMY_ATTACK,   // Enemy leaves formation and dives
+    TIMER_BOMB_DETONATE,  // Bomb stops and explodes
+    TIMER_BOMB_EXPIRE,    // Explosion has played out
+    TIMER_MISSILE_EXPIRE  // Missile runs out of fuel
+};
+
+// Hierarchical timing wheel over simulation ticks. Level 0 has a slot per tick, each higher level a slot
+// per turn of the level below; timers trickle down a level whenever the level below wraps. Advancing costs the timers that fire plus the occasional cascade, however many
+// timers are pending. Timers can't be cancelled: they name an entity, and the handler ignores timers
+// whose entity is gone or no longer in the state the timer was set for.
+class TimerWheel
+{
+public:
+    struct Timer
+    {
+        uint32_t due; // Tick the timer fires at
+        TimerKind kind;
+        Entity entity;
+    };
+
+    TimerWheel();
+    void Clear(uint32_t now); // Drop every timer and restart the clock at now
+    uint32_t Now() const { return now; }
+    void Schedule(uint32_t due, TimerKind kind, Entity entity); // Due ticks not after Now() fire at the next Advance
+    size_t Size() const { return pending; } // Timers not yet fired
+
+    // Moves the clock to tick, calling fire(timer) for every timer due by then in due order.
+    // fire may schedule more timers; any due by tick fire in this same call.
+    template <typename Fn>
+    void Advance(uint32_t tick, Fn fire)
+    {
+        while (now != tick)
+        {
+            now++;
+            Cascade();
+            // Swapped out so fire can schedule into the slot it is being called from
+            firing.swap(slots[now & (SLOTS - 1)]);
+            pending -= static_cast<uint32_t>(firing.size());
+            for (const Timer &timer : firing)
+            {
+                fire(timer);
+            }
+            firing.clear();
+        }
+    }
+
+    template <typename Writer>
+    void Save(Writer &writer) const
+    {
+        writer.Write(now);
+        writer.Write(pending);
+        writer.Write(slots);
+    }
+
+    template <typename Reader>
+    void Load(Reader &reader)
+    {
+        reader.Read(now);
+        reader.Read(pending);
+        reader.Read(slots);
+    }
+
+private:
+    static const int LEVELS = 4; // 64^4 ticks ahead, about three days at 60 Hz; later timers wait on the top level
+    static const int SLOT_BITS = 6;
+    static const uint32_t SLOTS = 1u << SLOT_BITS;
+
+    uint32_t now;
+    uint32_t pending;
+    TrackedVector<TrackedVector<Timer, MEMORY_ENTITIES>, MEMORY_ENTITIES> slots; // LEVELS * SLOTS, level 0 first
+    TrackedVector<Timer, MEMORY_ENTITIES> firing;
+
+    void Insert(const Timer &timer);
+    void Cascade(); // Moves the higher level slots that now come into range down a level
+};
+
+// Whole ticks closest to a duration, at least one
+inline uint32_t TicksFor(Scalar seconds, Scalar deltaTime)
+{
+    float ticks = ToFloat(seconds / deltaTime) + 0.5f;
+    return ticks < 1 ? 1 : static_cast<uint32_t>(ticks);
+}
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,48 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// Lock-free single producer / single consumer triple buffer.
+// The producer always has a slot to write, the consumer always has the newest complete slot to read,
+// and neither side ever waits for the other.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() : back(0), middle(1), front(2) {}
+
+    // Producer: slot to fill before calling Publish()
+    T &WriteBuffer()
+    {
+        return slots[back];
+    }
+
+    // Producer: hand the filled slot to the consumer
+    void Publish()
+    {
+        back = middle.exchange(back | DIRTY_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Consumer: swap in the newest published slot if there is one and return it.
+    // The reference stays valid until the next call.
+    const T &ReadBuffer()
+    {
+        if (middle.load(std::memory_order_relaxed) & DIRTY_BIT)
+        {
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return slots[front];
+    }
+
+private:
+    static const unsigned DIRTY_BIT = 4;  // Set when the middle slot holds unread data
+    static const unsigned INDEX_MASK = 3;
+
+    T slots[3];
+    unsigned back;                 // Owned by the producer
+    std::atomic<unsigned> middle;  // Shared hand-off slot
+    unsigned front;                // Owned by the consumer
+};
+
+#endif // TRIPLE_BUFFER_H
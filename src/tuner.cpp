@@ -0,0 +1,163 @@
+#include "tuner.h"
+#include "logger.h"
+#include "scripted_player.h"
+#include "world.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const int TICK_RATE = 60;
+    const int MAX_LEVEL = 5;                          // Games end once this level is cleared
+    const unsigned long MAX_TICKS = TICK_RATE * 60 * 20; // 20 simulated minutes, in case the player gets stuck
+
+    const int BASE_ENEMIES[] = {3, 5, 7};
+    const int ENEMIES_PER_LEVEL[] = {1, 2, 3};
+    const float SPEED_PER_LEVEL[] = {0.05f, 0.1f, 0.2f};
+
+    struct GameResult
+    {
+        int levelReached;             // Highest level started
+        bool cleared;                 // Cleared MAX_LEVEL before game over
+        float clearTime[MAX_LEVEL];   // Seconds spent on each cleared level, 0 if not cleared
+    };
+
+    GameResult PlayGame(World &world, uint32_t seed)
+    {
+        GameResult result = {};
+        world.Reset(seed);
+        result.levelReached = 1;
+        unsigned long levelStart = 0;
+        const Scalar deltaTime = Scalar(1) / Scalar(TICK_RATE);
+        ScriptedPlayer player;
+
+        while (!world.gameOver && world.tick < MAX_TICKS)
+        {
+            int level = world.level;
+            HandleGameplay(world, player.Decide(world), deltaTime);
+            if (world.level != level)
+            {
+                result.clearTime[level - 1] = static_cast<float>(world.tick - levelStart) / TICK_RATE;
+                levelStart = world.tick;
+                if (level == MAX_LEVEL)
+                {
+                    result.cleared = true;
+                    break;
+                }
+                result.levelReached = world.level;
+            }
+        }
+        return result;
+    }
+
+    float Percentile(std::vector<float> &values, float percentile)
+    {
+        if (values.empty())
+            return 0;
+        size_t index = std::min(values.size() - 1, static_cast<size_t>(values.size() * percentile / 100));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+}
+
+int RunDifficultyTuner(const Tuning &base, int gamesPerSetting)
+{
+    std::vector<Tuning> settings;
+    for (int baseEnemies : BASE_ENEMIES)
+    {
+        for (int enemiesPerLevel : ENEMIES_PER_LEVEL)
+        {
+            for (float speedPerLevel : SPEED_PER_LEVEL)
+            {
+                Tuning tuning = base;
+                tuning.baseEnemies = baseEnemies;
+                tuning.enemiesPerLevel = enemiesPerLevel;
+                tuning.enemySpeedPerLevel = speedPerLevel;
+                settings.push_back(tuning);
+            }
+        }
+    }
+
+    // Games are handed out in order, so each worker retunes its world only when it crosses into the next setting
+    size_t jobCount = settings.size() * gamesPerSetting;
+    std::vector<GameResult> results(jobCount);
+    std::atomic<size_t> nextJob(0);
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("Difficulty sweep: %zu settings x %d games on %u threads, up to level %d\n", settings.size(),
+                gamesPerSetting, threadCount, MAX_LEVEL);
+
+    // Spawning reports every wave; thousands of games would drown the table
+    SetLogLevel(LOG_LEVEL_WARNING);
+    Clock::time_point start = Clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned thread = 0; thread < threadCount; ++thread)
+    {
+        workers.emplace_back([&]()
+                             {
+            std::unique_ptr<World> world;
+            size_t setting = settings.size(); // Setting the world was last tuned for
+            for (size_t job = nextJob++; job < jobCount; job = nextJob++)
+            {
+                if (job / gamesPerSetting != setting)
+                {
+                    setting = job / gamesPerSetting;
+                    world.reset(new World(100, 100, 0, settings[setting], true));
+                }
+                // Every setting plays the same seeds, so differences come from the setting
+                results[job] = PlayGame(*world, static_cast<uint32_t>(job % gamesPerSetting + 1));
+            } });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    SetLogLevel(LOG_LEVEL_DEBUG);
+
+    std::printf("\nPer level: survival = games that cleared it / games that reached it; clear time p10/p50/p90 in seconds\n");
+    std::printf("%5s %5s %6s", "base", "+lvl", "speed");
+    for (int level = 1; level <= MAX_LEVEL; ++level)
+    {
+        char label[32];
+        std::snprintf(label, sizeof(label), "L%d surv p10/p50/p90", level);
+        std::printf(" | %19s", label);
+    }
+    std::printf(" | %6s\n", "all");
+
+    for (size_t setting = 0; setting < settings.size(); ++setting)
+    {
+        const Tuning &tuning = settings[setting];
+        std::printf("%5d %5d %6.2f", tuning.baseEnemies, tuning.enemiesPerLevel, ToFloat(tuning.enemySpeedPerLevel));
+        int allCleared = 0;
+        for (int level = 1; level <= MAX_LEVEL; ++level)
+        {
+            int reached = 0;
+            std::vector<float> clearTimes;
+            for (int game = 0; game < gamesPerSetting; ++game)
+            {
+                const GameResult &result = results[setting * gamesPerSetting + game];
+                if (result.levelReached >= level)
+                    reached++;
+                if (result.clearTime[level - 1] > 0)
+                    clearTimes.push_back(result.clearTime[level - 1]);
+                if (level == MAX_LEVEL && result.cleared)
+                    allCleared++;
+            }
+            float survival = reached ? 100.0f * clearTimes.size() / reached : 0;
+            std::printf(" | %3.0f%% %4.0f/%4.0f/%4.0f", survival, Percentile(clearTimes, 10), Percentile(clearTimes, 50),
+                        Percentile(clearTimes, 90));
+        }
+        std::printf(" | %5.0f%%\n", 100.0f * allCleared / gamesPerSetting);
+    }
+
+    std::printf("\n%zu games in %.1f s (%.1f games/s)\n", jobCount, seconds, jobCount / seconds);
+    return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef TUNER_H
+#define TUNER_H
+
+#include "tuning.h"
+
+// Plays gamesPerSetting headless games with a scripted player for every combination in a sweep of the
+// wave difficulty parameters, spread over all cores, and prints per-level survival and clear times.
+// Parameters outside the sweep come from base. Returns the process exit code.
+int RunDifficultyTuner(const Tuning &base, int gamesPerSetting); // --tune [GAMES]
+
+#endif // TUNER_H
@@ -0,0 +1,257 @@
+#include "tuning.h"
+#include "logger.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    struct TuningKey
+    {
+        const char *name;
+        Scalar Tuning::*scalar; // Exactly one of the two is set
+        int Tuning::*integer;
+        double min; // Accepted range, inclusive
+        double max;
+    };
+
+    // Ranges keep shots fast enough to leave the screen, waves non-empty and every value well inside
+    // the fixed-point range
+    const TuningKey KEYS[] = {
+        {"player_speed", &Tuning::playerSpeed, nullptr, 0.5, 100},
+        {"player_cooldown", &Tuning::playerCooldown, nullptr, 0.02, 10},
+        {"player_shot_speed", &Tuning::playerShotSpeed, nullptr, 50, 4000},
+        {"enemy_cooldown", &Tuning::enemyCooldown, nullptr, 0.1, 60},
+        {"enemy_shot_speed", &Tuning::enemyShotSpeed, nullptr, 20, 4000},
+        {"bomb_speed", &Tuning::bombSpeed, nullptr, 20, 4000},
+        {"enemy_enter_y", &Tuning::enemyEnterY, nullptr, 0, 1080},
+        {"formation_time", &Tuning::formationTime, nullptr, 0, 600},
+        {"base_enemies", nullptr, &Tuning::baseEnemies, 0, 200},
+        {"enemies_per_level", nullptr, &Tuning::enemiesPerLevel, 0, 100},
+        {"max_enemies", nullptr, &Tuning::maxEnemies, 1, 500},
+        {"enemy_base_speed", &Tuning::enemyBaseSpeed, nullptr, 0.1, 50},
+        {"enemy_speed_per_level", &Tuning::enemySpeedPerLevel, nullptr, 0, 1},
+        {"power_up_drop_percent", nullptr, &Tuning::powerUpDropPercent, 0, 100},
+        {"power_up_duration", &Tuning::powerUpDuration, nullptr, 0, 600},
+    };
+
+    const std::chrono::milliseconds POLL_INTERVAL(500);
+    const int INOTIFY_TIMEOUT_MS = 200; // How long Stop can take to be noticed
+
+    std::string Trim(const std::string &text)
+    {
+        size_t first = text.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+            return "";
+        size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    // Splits a path into directory and file name; inotify watches the directory so editors that
+    // save by writing a new file and renaming it over the old one are still seen
+    void SplitPath(const std::string &path, std::string &directory, std::string &name)
+    {
+        size_t slash = path.find_last_of("/\\");
+        directory = slash == std::string::npos ? "." : path.substr(0, slash);
+        name = slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+}
+
+Tuning ParseTuning(const std::string &text, std::vector<std::string> &errors)
+{
+    Tuning tuning;
+    std::istringstream lines(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line))
+    {
+        lineNumber++;
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos)
+        {
+            errors.push_back("line " + std::to_string(lineNumber) + ": expected key = value");
+            continue;
+        }
+
+        std::string key = Trim(line.substr(0, equals));
+        std::string value = Trim(line.substr(equals + 1));
+        const TuningKey *match = nullptr;
+        for (const TuningKey &candidate : KEYS)
+        {
+            if (key == candidate.name)
+                match = &candidate;
+        }
+        if (!match)
+        {
+            errors.push_back("line " + std::to_string(lineNumber) + ": unknown key " + key);
+            continue;
+        }
+
+        char *end = nullptr;
+        double number = match->scalar ? strtod(value.c_str(), &end) : strtol(value.c_str(), &end, 10);
+        if (end == value.c_str() || *end != '\0')
+        {
+            errors.push_back("line " + std::to_string(lineNumber) + ": " + key +
+                             (match->scalar ? " needs a number" : " needs a whole number"));
+            continue;
+        }
+        // The file is reloaded into a running game, so a value out of range keeps the default rather than breaking play
+        if (!(number >= match->min && number <= match->max))
+        {
+            std::ostringstream error;
+            error << "line " << lineNumber << ": " << key << " must be between " << match->min << " and " << match->max;
+            errors.push_back(error.str());
+            continue;
+        }
+
+        if (match->scalar)
+            tuning.*(match->scalar) = Scalar(static_cast<float>(number));
+        else
+            tuning.*(match->integer) = static_cast<int>(number);
+    }
+    return tuning;
+}
+
+bool LoadTuning(const std::string &path, Tuning &tuning)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::stringstream text;
+    text << file.rdbuf();
+    std::vector<std::string> errors;
+    tuning = ParseTuning(text.str(), errors);
+    for (const std::string &error : errors)
+    {
+        LOG_WARNING("tuning error", {{"path", path}, {"error", error}});
+    }
+    return true;
+}
+
+TuningWatcher::TuningWatcher(const std::string &path)
+    : path(path), quit(false), version(0), polledVersion(0)
+{
+}
+
+TuningWatcher::~TuningWatcher()
+{
+    Stop();
+}
+
+void TuningWatcher::Start()
+{
+    Load();
+    quit = false;
+    thread = std::thread(&TuningWatcher::Run, this);
+}
+
+void TuningWatcher::Stop()
+{
+    if (!thread.joinable())
+        return;
+    quit = true;
+    thread.join();
+}
+
+bool TuningWatcher::Poll(Tuning &tuning)
+{
+    unsigned current = version.load(std::memory_order_acquire);
+    if (current == polledVersion)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    tuning = latest;
+    polledVersion = current;
+    return true;
+}
+
+void TuningWatcher::Load()
+{
+    Tuning parsed;
+    if (!LoadTuning(path, parsed))
+        return; // Missing file keeps the current values; it is picked up once it appears
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        latest = parsed;
+    }
+    version.fetch_add(1, std::memory_order_release);
+    LOG_INFO("loaded tuning", {{"path", path}});
+}
+
+void TuningWatcher::Run()
+{
+    if (!WatchWithInotify())
+        WatchByPolling();
+}
+
+bool TuningWatcher::WatchWithInotify()
+{
+#ifdef __linux__
+    std::string directory, name;
+    SplitPath(path, directory, name);
+
+    int descriptor = inotify_init1(IN_NONBLOCK);
+    if (descriptor < 0)
+        return false;
+    if (inotify_add_watch(descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0)
+    {
+        close(descriptor);
+        return false;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    while (!quit)
+    {
+        pollfd request = {descriptor, POLLIN, 0};
+        if (poll(&request, 1, INOTIFY_TIMEOUT_MS) <= 0)
+            continue;
+
+        bool changed = false;
+        ssize_t length;
+        while ((length = read(descriptor, buffer, sizeof(buffer))) > 0)
+        {
+            for (char *event = buffer; event < buffer + length;)
+            {
+                const inotify_event *info = reinterpret_cast<const inotify_event *>(event);
+                if (info->len > 0 && name == info->name)
+                    changed = true;
+                event += sizeof(inotify_event) + info->len;
+            }
+        }
+        if (changed)
+            Load();
+    }
+    close(descriptor);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void TuningWatcher::WatchByPolling()
+{
+    struct stat info;
+    time_t lastModified = stat(path.c_str(), &info) == 0 ? info.st_mtime : 0;
+    while (!quit)
+    {
+        std::this_thread::sleep_for(POLL_INTERVAL);
+        if (stat(path.c_str(), &info) == 0 && info.st_mtime != lastModified)
+        {
+            lastModified = info.st_mtime;
+            Load();
+        }
+    }
+}
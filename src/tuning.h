@@ -0,0 +1,69 @@
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fixed.h"
+
+// Gameplay constants designers can change without a rebuild. Defaults match the shipped balance;
+// res/tuning.cfg overrides them and is reloaded while the game runs.
+struct Tuning
+{
+    // Player
+    Scalar playerSpeed = 7.5f;     // Pixels per 60 Hz frame
+    Scalar playerCooldown = 0.2f;  // Seconds between shots
+    Scalar playerShotSpeed = 450;  // Pixels per second
+    // Enemies
+    Scalar enemyCooldown = 2;      // Seconds between shots
+    Scalar enemyShotSpeed = 300;
+    Scalar bombSpeed = 180;
+    Scalar enemyEnterY = 100;      // Enemies take up formation once they are this far down
+    Scalar formationTime = 10;     // Seconds in formation before attacking
+    // Waves
+    int baseEnemies = 5;
+    int enemiesPerLevel = 2;
+    int maxEnemies = 20;
+    Scalar enemyBaseSpeed = 1.5f;
+    Scalar enemySpeedPerLevel = 0.1f; // Fraction of the base speed added per level
+    // Power-ups
+    int powerUpDropPercent = 8;
+    Scalar powerUpDuration = 10;
+};
+
+// Parses "key = value" lines ('#' starts a comment) on top of the defaults, so deleting a line
+// restores its default. Problems, including values outside a key's range, are reported in errors
+// and leave that key at its default.
+Tuning ParseTuning(const std::string &text, std::vector<std::string> &errors);
+// Reads and parses a tuning file, printing any errors. False if the file can't be opened.
+bool LoadTuning(const std::string &path, Tuning &tuning);
+
+// Watches a tuning file on a background thread (inotify on Linux, modification time polling
+// elsewhere) and parses it there, so the game thread only ever copies a finished Tuning.
+class TuningWatcher
+{
+public:
+    explicit TuningWatcher(const std::string &path);
+    ~TuningWatcher();
+    void Start(); // Loads the file once, then starts watching
+    void Stop();
+    bool Poll(Tuning &tuning); // Copies the newest tuning if it changed since the last Poll
+
+private:
+    std::string path;
+    std::thread thread;
+    std::atomic<bool> quit;
+    std::mutex mutex;
+    Tuning latest;
+    std::atomic<unsigned> version; // Bumped on every successful load
+    unsigned polledVersion;
+
+    void Run();
+    bool WatchWithInotify(); // False if inotify isn't available, so Run falls back to polling
+    void WatchByPolling();
+    void Load();
+};
+
+#endif // TUNING_H
@@ -0,0 +1,154 @@
+#include "wave_builder.h"
+#include "logger.h"
+#include "random.h"
+#include "systems.h"
+#include "world.h"
+#include <cstring>
+
+namespace
+{
+    bool SameRequest(const WaveRequest &a, const WaveRequest &b)
+    {
+        return a.level == b.level && a.wave == b.wave && a.seed == b.seed &&
+               memcmp(&a.tuning, &b.tuning, sizeof(Tuning)) == 0;
+    }
+}
+
+bool IsBossWave(int level, int wave)
+{
+    return wave == level + 2;
+}
+
+void BuildWave(const WaveRequest &request, EnemyArchetype &enemies)
+{
+    const Tuning &tuning = request.tuning;
+    int level = request.level;
+    Random random(request.seed);
+
+    // Increase number and difficulty of enemies based on level and wave
+    int numEnemies = tuning.baseEnemies + (level - 1) * tuning.enemiesPerLevel + request.wave;
+
+    // Cap max enemies to prevent overwhelming the screen
+    numEnemies = Min(numEnemies, tuning.maxEnemies);
+
+    // Increase enemy speed with levels
+    Scalar speedMultiplier = Scalar(1) + Scalar(level) * tuning.enemySpeedPerLevel;
+    Scalar enemySpeed = tuning.enemyBaseSpeed * speedMultiplier;
+
+    // Add formation patterns based on level
+    int columns = 5;
+
+    // Create enemies in a grid formation
+    for (int i = 0; i < numEnemies; ++i)
+    {
+        int row = i / columns;
+        int col = i % columns;
+        Scalar xPos = (VIRTUAL_WIDTH / (columns + 1)) * (col + 1);
+        Scalar yPos = -100 - (row * 80); // Start above screen with spacing
+
+        // Determine enemy color based on level
+        Color enemyColor;
+        if (level == 1)
+        {
+            enemyColor = (random.Range(0, 1) == 0) ? RED : ORANGE;
+        }
+        else if (level == 2)
+        {
+            int colorChoice = random.Range(0, 2);
+            enemyColor = (colorChoice == 0) ? RED : (colorChoice == 1) ? ORANGE
+                                                                       : PINK;
+        }
+        else
+        {
+            int colorChoice = random.Range(0, 3);
+            enemyColor = (colorChoice == 0) ? RED : (colorChoice == 1) ? ORANGE
+                                                : (colorChoice == 2)   ? PINK
+                                                                       : PURPLE;
+        }
+
+        SpawnEnemy(enemies, xPos, yPos, enemySpeed, enemyColor, tuning);
+    }
+
+    LOG_INFO("built wave", {{"level", level}, {"wave", request.wave}, {"enemies", numEnemies}, {"speed", ToFloat(enemySpeed)}});
+}
+
+WaveBuilder::WaveBuilder() : quit(false), pending(false), building(false), ready(false), request()
+{
+}
+
+WaveBuilder::~WaveBuilder()
+{
+    Stop();
+}
+
+void WaveBuilder::Start()
+{
+    quit = false;
+    thread = std::thread(&WaveBuilder::Run, this);
+}
+
+void WaveBuilder::Stop()
+{
+    if (!thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    stateChanged.notify_all();
+    thread.join();
+}
+
+void WaveBuilder::Request(const WaveRequest &request)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->request = request;
+        pending = true;
+        ready = false;
+    }
+    stateChanged.notify_all();
+}
+
+bool WaveBuilder::Take(const WaveRequest &request, EnemyArchetype &enemies)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!(pending || building || ready) || !SameRequest(request, this->request))
+        return false;
+    stateChanged.wait(lock, [this] { return !pending && !building; });
+    if (!ready || !SameRequest(request, this->request))
+        return false;
+    enemies.Append(built);
+    ready = false;
+    return true;
+}
+
+void WaveBuilder::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        stateChanged.wait(lock, [this] { return quit || pending; });
+        if (quit)
+            return;
+
+        WaveRequest job = request;
+        pending = false;
+        building = true;
+        lock.unlock();
+
+        // Built outside the lock into a scratch archetype, so Take never sees a half built wave
+        EnemyArchetype wave;
+        BuildWave(job, wave);
+
+        lock.lock();
+        building = false;
+        if (!pending)
+        {
+            std::swap(built, wave);
+            ready = true;
+        }
+        stateChanged.notify_all();
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef WAVE_BUILDER_H
+#define WAVE_BUILDER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "components.h"
+#include "tuning.h"
+
+// Everything a regular wave's enemies are built from. The same inputs always build the same wave.
+struct WaveRequest
+{
+    int level;
+    int wave;
+    uint32_t seed; // Drawn from the world's generator when the previous wave started
+    Tuning tuning;
+};
+
+bool IsBossWave(int level, int wave); // The last wave of every level is a boss
+void BuildWave(const WaveRequest &request, EnemyArchetype &enemies); // Adds a regular wave's enemies
+
+// Builds the next regular wave on a worker thread while the current one is played, so the wave change
+// only copies finished rows into the world. Boss waves are a handful of entities and spawn on the spot.
+class WaveBuilder
+{
+public:
+    WaveBuilder();
+    ~WaveBuilder();
+    void Start();
+    void Stop();
+    void Request(const WaveRequest &request); // Replaces any earlier request
+    // Appends the wave to enemies if it was requested with exactly these inputs, waiting for the worker
+    // if it is still busy on it. False if it wasn't, and the caller has to build the wave itself.
+    bool Take(const WaveRequest &request, EnemyArchetype &enemies);
+
+private:
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable stateChanged;
+    bool quit;
+    bool pending;  // Request not yet picked up by the worker
+    bool building; // Worker busy on request
+    bool ready;    // built holds the wave for request
+    WaveRequest request;
+    EnemyArchetype built;
+
+    void Run();
+};
+
+#endif // WAVE_BUILDER_H
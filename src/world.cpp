@@ -0,0 +1,257 @@
+#include "world.h"
+#include "systems.h"
+#include "boss.h"
+#include "emitter.h"
+#include "logger.h"
+#include "telemetry.h"
+
+namespace
+{
+    // Enemies enter from above the screen and can dive below it, so the grid reaches past both edges
+    const int ENEMY_GRID_MARGIN = 256;
+    const int ENEMY_GRID_CELL_SIZE = 64;
+
+    // Hands the regular wave after the current one to the builder
+    void RequestNextWave(const World &world)
+    {
+        int level = world.level;
+        int wave = world.wave + 1;
+        if (wave > level + 2)
+        {
+            level++;
+            wave = 1;
+        }
+        if (world.waveBuilder && !IsBossWave(level, wave))
+            world.waveBuilder->Request({level, wave, world.nextWaveSeed, world.tuning});
+    }
+}
+
+World::World(int playerWidth, int playerHeight, uint32_t seed, const Tuning &tuning, bool headless)
+    : playerWidth(playerWidth), playerHeight(playerHeight),
+      enemyGrid(-ENEMY_GRID_MARGIN, -2 * ENEMY_GRID_MARGIN, VIRTUAL_WIDTH + 2 * ENEMY_GRID_MARGIN,
+                VIRTUAL_HEIGHT + 3 * ENEMY_GRID_MARGIN, ENEMY_GRID_CELL_SIZE),
+      tuning(tuning), seed(seed), nextWaveSeed(0), waveBuilder(nullptr), heatmap(nullptr), score(0), level(1), wave(1), gameOver(false), musicCue(0), tick(0), retired(0)
+{
+    // Create stars
+    const int numStars = headless ? 0 : 100;
+    for (int i = 0; i < numStars; ++i)
+    {
+        stars.emplace_back(VIRTUAL_WIDTH, VIRTUAL_HEIGHT);
+    }
+
+    Reset(seed);
+}
+
+void World::Reset(uint32_t seed)
+{
+    this->seed = seed;
+    random.Seed(seed);
+    players.Clear();
+    enemies.Clear();
+    playerShots.Clear();
+    enemyShots.Clear();
+    bombs.Clear();
+    missiles.Clear();
+    powerUps.Clear();
+    emitters.Clear();
+    bosses.Clear();
+    enemyGrid.Clear();
+    timers.Clear(0);
+    SpawnPlayer(players, Scalar(VIRTUAL_WIDTH) / 2, Scalar(VIRTUAL_HEIGHT) * 0.95f, playerWidth, playerHeight, tuning);
+    score = 0;
+    level = 1;
+    wave = 1;
+    gameOver = false;
+    musicCue++;
+    tick = 0;
+    retired = 0;
+    SetTelemetryTick(0);
+    // Reset runs outside the tick loop, so the first wave goes straight to telemetry rather than through the event bus
+    events.clear();
+    RecordTelemetry(TELEMETRY_SESSION, static_cast<int32_t>(seed));
+    RecordTelemetry(TELEMETRY_WAVE, level, wave);
+    nextWaveSeed = random.Next();
+    SpawnEnemies(*this);
+}
+
+void SpawnEnemies(World &world)
+{
+    if (IsBossWave(world.level, world.wave))
+    {
+        SpawnBoss(world.enemies, world.bosses, world.emitters, Scalar(VIRTUAL_WIDTH) / 2, -100, world.level);
+        LOG_INFO("spawned boss", {{"level", world.level}});
+    }
+    else
+    {
+        // Normally the builder has had the whole last wave to get this one ready
+        WaveRequest request = {world.level, world.wave, world.nextWaveSeed, world.tuning};
+        if (!world.waveBuilder || !world.waveBuilder->Take(request, world.enemies))
+            BuildWave(request, world.enemies);
+        world.nextWaveSeed = world.random.Next();
+    }
+    RequestNextWave(world);
+}
+
+void ApplyTuning(World &world, const Tuning &tuning)
+{
+    world.tuning = tuning;
+
+    // Speeds and cooldowns are copied into components at spawn, so push the new values into them
+    for (Pilot &pilot : world.players.Column<Pilot>())
+    {
+        pilot.movementSpeed = tuning.playerSpeed;
+    }
+    for (Weapon &weapon : world.players.Column<Weapon>())
+    {
+        weapon.cooldown = tuning.playerCooldown;
+    }
+    const auto &brains = world.enemies.Column<EnemyBrain>();
+    auto &weapons = world.enemies.Column<Weapon>();
+    for (size_t i = 0; i < world.enemies.Size(); ++i)
+    {
+        if (brains[i].state != BOSS)
+            weapons[i].cooldown = tuning.enemyCooldown;
+    }
+    RequestNextWave(world); // The queued wave was built with the old values
+}
+
+void HandleGameplay(World &world, const PlayerInput &input, Scalar deltaTime)
+{
+    world.events.clear(); // Even when the game is over, so nothing is published twice
+    if (world.gameOver)
+        return;
+
+    world.tick++;
+    world.retired = 0;
+    SetTelemetryTick(static_cast<uint32_t>(world.tick));
+
+    // Timers due this tick act before anything moves
+    world.retired += static_cast<int>(TimerSystem(world.timers, static_cast<uint32_t>(world.tick), world.enemies, world.enemyShots,
+                                                  world.bombs, world.missiles, world.tuning, deltaTime, world.random));
+
+    int screenWidth = VIRTUAL_WIDTH;
+    int screenHeight = VIRTUAL_HEIGHT;
+
+    for (auto &star : world.stars)
+    {
+        star.Update(screenWidth, screenHeight);
+    }
+
+    // Behaviour and movement
+    PlayerSystem(world.players, world.playerShots, world.missiles, world.timers, input, world.tuning, deltaTime, screenWidth,
+                 screenHeight, world.events);
+    EnemyBehaviourSystem(world.enemies, world.timers, world.tuning, deltaTime, screenWidth);
+    world.retired += static_cast<int>(EnemyVisibilitySystem(world.enemies, screenHeight));
+    const auto &brains = world.enemies.Column<EnemyBrain>();
+    world.enemyGrid.Sync(world.enemies, [&](size_t i) { return !brains[i].asleep; }); // Sleepers can't be hit or chased
+    HomingSystem(world.missiles, world.enemyGrid, deltaTime);
+    EmitterSystem(world.emitters, world.enemies, world.players, world.enemyShots, deltaTime);
+    FuseSystem(world.bombs, deltaTime);
+    MovementSystem(world.playerShots, deltaTime);
+    MovementSystem(world.missiles, deltaTime);
+    MovementSystem(world.enemyShots, deltaTime);
+    MovementSystem(world.bombs, deltaTime);
+    MovementSystem(world.powerUps, deltaTime);
+
+    // Collisions
+    world.kills.clear();
+    ShotCollisionSystem(world.playerShots, world.enemies, world.bosses, world.emitters, world.enemyGrid, deltaTime, world.kills,
+                        world.events);
+    ShotCollisionSystem(world.missiles, world.enemies, world.bosses, world.emitters, world.enemyGrid, deltaTime, world.kills,
+                        world.events);
+    BossCleanupSystem(world.bosses, world.enemies);
+    world.score += static_cast<int>(world.kills.size()) * 100; // Base score per enemy
+    PowerUpDropSystem(world.kills, world.powerUps, world.tuning, world.random);
+    PowerUpPickupSystem(world.players, world.powerUps, world.tuning, world.events);
+    if (PlayerCollisionSystem(world.players, world.enemies, world.bosses, world.enemyShots, world.bombs, deltaTime) > 0)
+    {
+        // Clear projectiles when the player loses a life
+        world.playerShots.Clear();
+        world.missiles.Clear();
+        int lives = world.players.Column<Pilot>()[0].lives;
+        const Position &position = world.players.Column<Position>()[0];
+        world.gameOver = lives <= 0;
+        RaiseEvent(world.events, EVENT_PLAYER_DEATH, ToFloat(position.x), ToFloat(position.y), lives);
+        if (world.gameOver)
+            RaiseEvent(world.events, EVENT_GAME_OVER, ToFloat(position.x), ToFloat(position.y), world.score);
+    }
+
+    // Lifetime
+    size_t retired = OffScreenSystem(world.playerShots, screenWidth, screenHeight);
+    retired += OffScreenSystem(world.missiles, screenWidth, screenHeight);
+    retired += OffScreenSystem(world.enemyShots, screenWidth, screenHeight);
+    retired += OffScreenSystem(world.bombs, screenWidth, screenHeight);
+    retired += OffScreenSystem(world.powerUps, screenWidth, screenHeight);
+    world.retired += static_cast<int>(retired);
+    RespawnSystem(world.players, world.enemies, screenWidth, screenHeight);
+
+    // Spawn next wave once all enemies are destroyed or off-screen
+    bool playerExploding = world.players.Column<Pilot>()[0].exploding;
+    if (!world.gameOver && !playerExploding && AllEnemiesGone(world.enemies, screenHeight))
+    {
+        world.wave++;
+        if (world.wave > world.level + 2)
+        {
+            world.level++;
+            world.wave = 1;
+            world.musicCue++;
+        }
+        RaiseEvent(world.events, EVENT_WAVE_START, VIRTUAL_WIDTH / 2.0f, 0, world.level, world.wave);
+        world.enemies.Clear();
+        SpawnEnemies(world);
+    }
+
+    // Analytics, a few counter increments per tick
+    if (world.heatmap)
+    {
+        const auto &positions = world.players.Column<Position>();
+        const auto &pilots = world.players.Column<Pilot>();
+        for (size_t i = 0; i < world.players.Size(); ++i)
+        {
+            if (!pilots[i].exploding)
+                world.heatmap->Add(HEAT_PLAYER, ToFloat(positions[i].x), ToFloat(positions[i].y));
+        }
+        world.heatmap->AddEvents(world.events);
+    }
+}
+
+void BuildSnapshot(const World &world, RenderSnapshot &snapshot)
+{
+    snapshot.Clear();
+
+    for (const auto &star : world.stars)
+    {
+        star.Draw(snapshot);
+    }
+
+    // Anything wholly outside the virtual screen is left out of the snapshot
+    const Box viewport = {0, 0, VIRTUAL_WIDTH, VIRTUAL_HEIGHT};
+    RenderEnemies(world.enemies, viewport, snapshot);
+    RenderBosses(world.bosses, world.enemies, viewport, snapshot);
+    RenderShots(world.enemyShots, viewport, snapshot);
+    RenderBombs(world.bombs, viewport, snapshot);
+    RenderPowerUps(world.powerUps, viewport, snapshot);
+    RenderPlayers(world.players, snapshot);
+    RenderShots(world.playerShots, viewport, snapshot);
+    RenderMissiles(world.missiles, viewport, snapshot);
+
+    snapshot.entities.live = static_cast<int>(world.players.Size() + world.enemies.Size() + world.playerShots.Size() +
+                                              world.enemyShots.Size() + world.bombs.Size() + world.missiles.Size() +
+                                              world.powerUps.Size());
+    for (const EnemyBrain &brain : world.enemies.Column<EnemyBrain>())
+    {
+        snapshot.entities.sleeping += brain.asleep ? 1 : 0;
+    }
+    snapshot.entities.retired = world.retired;
+
+    snapshot.score = world.score;
+    const Pilot &pilot = world.players.Column<Pilot>()[0];
+    snapshot.lives = pilot.lives;
+    snapshot.weaponMode = pilot.weaponMode;
+    snapshot.weaponTime = ToFloat(pilot.weaponTime);
+    snapshot.level = world.level;
+    snapshot.wave = world.wave;
+    snapshot.gameOver = world.gameOver;
+    snapshot.musicCue = world.musicCue;
+    snapshot.tick = world.tick;
+}
@@ -0,0 +1,65 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <vector>
+#include "star.h"
+#include "components.h"
+#include "events.h"
+#include "heatmap.h"
+#include "input.h"
+#include "random.h"
+#include "snapshot.h"
+#include "spatial_grid.h"
+#include "timer_wheel.h"
+#include "tuning.h"
+#include "wave_builder.h"
+
+// Virtual resolution the simulation runs in
+const int VIRTUAL_WIDTH = 1920;
+const int VIRTUAL_HEIGHT = 1080;
+
+// Everything the simulation owns. Only the simulation thread touches it while the game is running.
+struct World
+{
+    // Headless worlds get no background stars: nobody draws them, and stars draw from raylib's random
+    // generator, which isn't safe to share between worlds running on different threads
+    World(int playerWidth, int playerHeight, uint32_t seed, const Tuning &tuning, bool headless = false);
+    void Reset(uint32_t seed); // Start a new game; the same seed and inputs replay the same game
+
+    int playerWidth;
+    int playerHeight;
+    PlayerArchetype players;
+    EnemyArchetype enemies;
+    ShotArchetype playerShots;
+    ShotArchetype enemyShots;
+    BombArchetype bombs;
+    MissileArchetype missiles;
+    PowerUpArchetype powerUps;
+    EmitterArchetype emitters; // Bullet pattern emitters mounted on bosses
+    BossArchetype bosses;      // Part hierarchies of boss enemies
+    SpatialGrid enemyGrid;      // Enemy positions for nearest-enemy and collision queries, synced every tick
+    TimerWheel timers;          // Scheduled enemy actions, fuses and expiries, on the tick clock
+    TrackedVector<Position, MEMORY_ENTITIES> kills; // Enemies destroyed this tick
+    GameEventBuffer events;                         // Raised during the last tick
+    StarField stars;
+    Tuning tuning; // Kept across games; changed only through ApplyTuning
+    Random random;
+    uint32_t seed; // Seed the current game started from
+    uint32_t nextWaveSeed; // Drawn at the start of each wave for the regular wave after it
+    WaveBuilder *waveBuilder; // Builds the next wave in the background; null builds waves on the spot
+    Heatmap *heatmap;         // Accumulates where the player flies, dies and kills; null records nothing
+    int score;
+    int level;
+    int wave;
+    bool gameOver;
+    int musicCue;       // Bumped whenever the level start music should play
+    unsigned long tick; // Simulation ticks since the game started
+    int retired;        // Entities expiry timers and the lifetime systems removed during the last tick
+};
+
+void SpawnEnemies(World &world); // Spawns world.wave of world.level and queues the wave after it
+void ApplyTuning(World &world, const Tuning &tuning); // Also updates entities that copied the old values
+void HandleGameplay(World &world, const PlayerInput &input, Scalar deltaTime);
+void BuildSnapshot(const World &world, RenderSnapshot &snapshot);
+
+#endif // WORLD_H